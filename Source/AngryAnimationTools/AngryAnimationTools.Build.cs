@@ -13,6 +13,7 @@ public class AngryAnimationTools : ModuleRules
 			new string[]
 			{
 				"Core",
+				"TraceLog",
 			}
 			);
 			
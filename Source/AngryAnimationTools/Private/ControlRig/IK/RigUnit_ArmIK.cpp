@@ -10,8 +10,10 @@
 FRigUnit_ArmIK_Execute()
 {
 	DECLARE_SCOPE_HIERARCHICAL_COUNTER_RIGUNIT();
+	ANGRY_RIGUNIT_TRACE_SCOPE(ArmIK);
+	ANGRY_RIGUNIT_TRACE_COUNT(ChainLength, Chain.Num());
 	URigHierarchy* Hierarchy = ExecuteContext.Hierarchy;
-	FRigVMDrawInterface* DrawInterface = ExecuteContext.GetDrawInterface();
+	FRigVMDrawInterface* DrawInterface = DebugSettings.IsEnabled() ? ExecuteContext.GetDrawInterface() : nullptr;
 	if (!Hierarchy)
 	{
 		return;
@@ -21,17 +23,23 @@ FRigUnit_ArmIK_Execute()
 	{
 		UE_CONTROLRIG_RIGUNIT_REPORT_WARNING(TEXT("Chain has to have length at least 3."));
 	}
+	else if (!ChainCache.Update(Chain, Hierarchy))
+	{
+		UE_CONTROLRIG_RIGUNIT_REPORT_WARNING(TEXT("Chain contains invalid elements."));
+	}
 	else
 	{
+		TArray<FCachedRigElement>& CachedChain = ChainCache.CachedChain;
+
 		// Objective properties
 		const FTransform EndEETarget = GET_IK_OBJECTIVE_TRANSFORM();
 		const FVector EEForwardTarget = GET_IK_OBJECTIVE_FORWARD();
 		const FVector EELocation = EndEETarget.GetLocation();
 
 		// Compute initial leg properties
-		const FTransform InitialUpperArm = Hierarchy->GetGlobalTransform(Chain[0]);
-		const FTransform InitialLowerArm = Hierarchy->GetGlobalTransform(Chain[1]);
-		const FTransform InitialHand = Hierarchy->GetGlobalTransform(Chain[2]);
+		const FTransform InitialUpperArm = Hierarchy->GetGlobalTransform(CachedChain[0]);
+		const FTransform InitialLowerArm = Hierarchy->GetGlobalTransform(CachedChain[1]);
+		const FTransform InitialHand = Hierarchy->GetGlobalTransform(CachedChain[2]);
 
 		FVector2D Lengths;
 		Lengths.X = (InitialUpperArm.GetLocation() - InitialLowerArm.GetLocation()).Size() * Customisation.X;
@@ -41,7 +49,7 @@ FRigUnit_ArmIK_Execute()
 		const FVector InitialHandDelta = InitialHand.GetLocation() - InitialUpperArm.GetLocation();
 
 		// Compute shoulder direction
-		const FTransform Shoulder = Hierarchy->GetGlobalTransform(Chain[0]);
+		const FTransform& Shoulder = InitialUpperArm;
 		const FVector ShoulderObjectiveDelta = EELocation - Shoulder.GetLocation();
 		const float ShoulderObjectiveDistance = ShoulderObjectiveDelta.Size();
 		const FVector ShoulderObjectiveNormal = ShoulderObjectiveDelta / ShoulderObjectiveDistance;
@@ -64,7 +72,7 @@ FRigUnit_ArmIK_Execute()
 		const FVector InitialArmDelta = FVector::VectorPlaneProject(InitialEllbowDelta, InitialHandNormal);
 		const FVector ArmDirection = (ArmRotation * InitialArmDelta).GetSafeNormal();
 
-		if (DebugSettings.bEnabled)
+		if (DebugSettings.IsEnabled())
 		{
 			DrawInterface->DrawLine(FTransform::Identity, ShoulderLocation, ShoulderLocation + ArmDirection * 50.0f, FLinearColor::White, DebugSettings.Scale * 0.5f);
 		}
@@ -74,7 +82,7 @@ FRigUnit_ArmIK_Execute()
 		const FVector HandAlignment = EEForwardTarget * (EEAlignment | ObjectiveNormal) - EEAlignment * (EEForwardTarget | ObjectiveNormal);
 		const FVector LowerDirection = FVector::VectorPlaneProject(HandAlignment * Lengths.Y + ArmDirection * Lengths.X, ObjectiveNormal).GetSafeNormal();
 
-		if (DebugSettings.bEnabled)
+		if (DebugSettings.IsEnabled())
 		{
 			DrawInterface->DrawLine(FTransform::Identity, ObjectiveLocation, ObjectiveLocation + HandAlignment * 30.0f, FLinearColor::Black, DebugSettings.Scale * 0.5f);
 		}
@@ -87,7 +95,7 @@ FRigUnit_ArmIK_Execute()
 		const FVector EllbowDelta = ObjectiveNormal * EllbowKath + LowerDirection * EllbowHeight;
 		const FVector EllbowLocation = ShoulderLocation + EllbowDelta;
 
-		if (DebugSettings.bEnabled)
+		if (DebugSettings.IsEnabled())
 		{
 			DrawInterface->DrawLine(FTransform::Identity, EllbowLocation, EllbowLocation + LowerDirection * 20.0f, FLinearColor::Green, DebugSettings.Scale * 0.5f);
 
@@ -97,15 +105,15 @@ FRigUnit_ArmIK_Execute()
 		}
 
 		// Transform to propagate along the arm
-		FRigUnit_BendTowards::BendTowards(Chain[0], Chain[1], EllbowLocation, Hierarchy, ScaleType, PropagateToChildren == EPropagation::All);
-		FRigUnit_BendTowards::BendTowards(Chain[1], Chain[2], ObjectiveLocation, Hierarchy, ScaleType, PropagateToChildren == EPropagation::All);
+		FRigUnit_BendTowards::BendTowards(CachedChain[0], CachedChain[1], EllbowLocation, Hierarchy, ScaleType, PropagateToChildren == EPropagation::All);
+		FRigUnit_BendTowards::BendTowards(CachedChain[1], CachedChain[2], ObjectiveLocation, Hierarchy, ScaleType, PropagateToChildren == EPropagation::All);
 
 		// Set foot transform
 		FTransform EE;
-		EE.SetScale3D(Hierarchy->GetInitialGlobalTransform(Chain[2]).GetScale3D());
+		EE.SetScale3D(ChainCache.InitialTransforms[2].GetScale3D());
 		EE.SetRotation(EndEETarget.GetRotation());
 		EE.SetLocation(ObjectiveLocation);
-		Hierarchy->SetGlobalTransform(Chain[2], EE, false, PropagateToChildren != EPropagation::Off);
+		FRigTracedWrite::SetGlobalTransform(Hierarchy, CachedChain[2], EE, false, PropagateToChildren != EPropagation::Off);
 
 		Stretch = ObjectiveDistance / InitialHandDelta.Size();
 	}
@@ -6,12 +6,61 @@
 
 #include "ControlRig.h"
 #include "Units/RigUnitContext.h"
+#include "Algo/BinarySearch.h"
+
+FVector FRigUnit_BSplineIK_WorkData::Evaluate(const FVector& P0, const FVector& P1, const FVector& P2, const FVector& P3, float Alpha)
+{
+	const float InvAlpha = 1.0f - Alpha;
+	const float A = InvAlpha * InvAlpha * InvAlpha;
+	const float B = 3.0f * InvAlpha * InvAlpha * Alpha;
+	const float C = 3.0f * InvAlpha * Alpha * Alpha;
+	const float D = Alpha * Alpha * Alpha;
+	return P0 * A + P1 * B + P2 * C + P3 * D;
+}
+
+void FRigUnit_BSplineIK_WorkData::Build(const FVector& P0, const FVector& P1, const FVector& P2, const FVector& P3, int32 SampleNum)
+{
+	SampleNum = FMath::Max(SampleNum, 2);
+	ArcLengths.SetNumUninitialized(SampleNum + 1, false);
+	ArcLengths[0] = 0.0f;
+
+	FVector Previous = P0;
+	for (int32 Sample = 1; Sample <= SampleNum; Sample++)
+	{
+		const FVector Current = Evaluate(P0, P1, P2, P3, ((float)Sample) / SampleNum);
+		ArcLengths[Sample] = ArcLengths[Sample - 1] + (Current - Previous).Size();
+		Previous = Current;
+	}
+}
+
+float FRigUnit_BSplineIK_WorkData::FindParameter(float Ratio) const
+{
+	const int32 SampleNum = ArcLengths.Num() - 1;
+	const float Length = ArcLengths.Last();
+	if (SampleNum < 1 || FMath::IsNearlyZero(Length))
+	{
+		return Ratio;
+	}
+
+	// Allow going past the spline ends by extrapolating linearly in parameter space
+	const float Distance = Ratio * Length;
+	if (Distance <= 0.0f || Distance >= Length)
+	{
+		return Ratio;
+	}
+
+	const int32 Upper = FMath::Clamp(Algo::LowerBound(ArcLengths, Distance), 1, SampleNum);
+	const float Segment = ArcLengths[Upper] - ArcLengths[Upper - 1];
+	const float Alpha = FMath::IsNearlyZero(Segment) ? 0.0f : (Distance - ArcLengths[Upper - 1]) / Segment;
+	return (Upper - 1 + Alpha) / SampleNum;
+}
 
 FRigUnit_BSplineIK_Execute()
 {
 	DECLARE_SCOPE_HIERARCHICAL_COUNTER_RIGUNIT();
+	ANGRY_RIGUNIT_TRACE_SCOPE(BSplineIK);
+	ANGRY_RIGUNIT_TRACE_COUNT(ChainLength, Chain.Num());
 	URigHierarchy* Hierarchy = ExecuteContext.Hierarchy;
-	FRigVMDrawInterface* DrawInterface = ExecuteContext.GetDrawInterface();
 	if (!Hierarchy)
 	{
 		return;
@@ -22,22 +71,17 @@ FRigUnit_BSplineIK_Execute()
 	{
 		UE_CONTROLRIG_RIGUNIT_REPORT_WARNING(TEXT("Chain has to have length at least 2."));
 	}
+	else if (!ChainCache.Update(Chain, Hierarchy))
+	{
+		UE_CONTROLRIG_RIGUNIT_REPORT_WARNING(TEXT("Chain contains invalid elements."));
+	}
 	else
 	{
-		// Extract length information from initial chain
-		TArray<float> Lengths;
-		Lengths.SetNumZeroed(ChainCount - 1);
-		float TotalDistance = 0.0f;
+		TArray<FCachedRigElement>& CachedChain = ChainCache.CachedChain;
 
-		FVector Current = Hierarchy->GetInitialGlobalTransform(Chain[0]).GetLocation();
-		for (int32 Index = 1; Index < ChainCount; Index++)
-		{
-			const FVector Next = Hierarchy->GetInitialGlobalTransform(Chain[Index]).GetLocation();
-			const float Length = (Current - Next).Size();
-			Lengths[Index - 1] = Length;
-			TotalDistance += Length;
-			Current = Next;
-		}
+		// Length information from initial chain
+		const TArray<float>& Lengths = ChainCache.InitialLengths;
+		const float TotalDistance = ChainCache.InitialChainLength;
 
 		if (FMath::IsNearlyZero(TotalDistance))
 		{
@@ -48,40 +92,51 @@ FRigUnit_BSplineIK_Execute()
 			const FTransform EndEETarget = GET_IK_OBJECTIVE_TRANSFORM();
 			const float InvTotalDistance = PositionAlongSpline / TotalDistance;
 
-			// Define B-Spline
-			const FTransform Origin = Hierarchy->GetGlobalTransform(Chain.First());
+			// Define cubic spline
+			const FTransform Origin = Hierarchy->GetGlobalTransform(CachedChain[0]);
 			const float TargetDistance = (Origin.GetLocation() - EndEETarget.GetLocation()).Size();
 
 			const FVector StartAnchor = Origin.GetLocation() + TangentStart * (TargetDistance * Bend);
 			const FVector EndAnchor = EndEETarget.GetLocation() + TangentEnd * (TargetDistance * Bend);
-			auto LerpSpline = [&](float Alpha) -> FVector {
-				return FMath::Lerp(FMath::Lerp(Origin.GetLocation(), StartAnchor, Alpha), FMath::Lerp(EndAnchor, EndEETarget.GetLocation(), Alpha), FMath::SmoothStep(0.f, 1.f, Alpha));
-			};
+			WorkData.Build(Origin.GetLocation(), StartAnchor, EndAnchor, EndEETarget.GetLocation(), ArcLengthSamples);
+
+			// Only record debug primitives if enabled
+			FRigDebugBuffer* Debug = DebugSettings.IsEnabled() ? &ChainCache.DebugBuffer : nullptr;
 
 			// Build spline
+			TArray<FTransform>& Transforms = ChainCache.WriteBack.Transforms;
+			FTransform Transform = Origin;
 			float Distance = 0.0f;
 			for (int32 Index = 1; Index < ChainCount; Index++)
 			{
 				// Compute distance and next target along spline
 				const float NextDistance = Distance + Lengths[Index - 1] * InvTotalDistance;
-				const FVector NextLocation = LerpSpline(NextDistance);
+				const FVector NextLocation = FRigUnit_BSplineIK_WorkData::Evaluate(Origin.GetLocation(), StartAnchor, EndAnchor, EndEETarget.GetLocation(), WorkData.FindParameter(NextDistance));
 				Distance = NextDistance;
 
-				if (DebugSettings.bEnabled)
+				if (Debug)
 				{
-					DrawInterface->DrawPoint(FTransform::Identity, NextLocation, DebugSettings.Scale * 2.0f, FLinearColor::Red);
+					Debug->AddPoint(NextLocation, DebugSettings.Scale * 2.0f, FLinearColor::Red);
 				}
 
 				// Compute transform and prepare next iteration
-				FRigUnit_BendTowards::BendTowards(Chain[Index - 1], Chain[Index], NextLocation, Hierarchy, ScaleType, PropagateToChildren == EPropagation::All);
+				const FTransform Local = ChainCache.WriteBack.GetLocalTransform(Hierarchy, Index);
+				FTransform Next;
+				Transforms[Index - 1] = FRigUnit_BendTowards::BendTransform(Transform, Local, NextLocation, ScaleType, 1.0f, Next);
+				Transform = Next;
 			}
 
 			// Set last member of chain
-			FTransform EE = Hierarchy->GetGlobalTransform(Chain.Last());
-			EE.SetRotation(FQuat::Slerp(EndEETarget.GetRotation(), EE.GetRotation(), RotateWithTangent));
-			EE.SetScale3D(Objective.GetScale3D());
-			EE.SetLocation(EE.GetLocation());
-			Hierarchy->SetGlobalTransform(Chain.Last(), EE, false, PropagateToChildren != EPropagation::Off);
+			Transform.SetRotation(FQuat::Slerp(EndEETarget.GetRotation(), Transform.GetRotation(), RotateWithTangent));
+			Transform.SetScale3D(Objective.GetScale3D());
+			Transforms.Last() = Transform;
+
+			ChainCache.WriteBack.Commit(Hierarchy, PropagateToChildren);
+
+			if (Debug)
+			{
+				Debug->Flush(ExecuteContext.GetDrawInterface());
+			}
 		}
 	}
 }
@@ -10,8 +10,10 @@
 FRigUnit_ClaviceIK_Execute()
 {
 	DECLARE_SCOPE_HIERARCHICAL_COUNTER_RIGUNIT();
+	ANGRY_RIGUNIT_TRACE_SCOPE(ClaviceIK);
+	ANGRY_RIGUNIT_TRACE_COUNT(ChainLength, Chain.Num());
 	URigHierarchy* Hierarchy = ExecuteContext.Hierarchy;
-	FRigVMDrawInterface* DrawInterface = ExecuteContext.GetDrawInterface();
+	FRigVMDrawInterface* DrawInterface = DebugSettings.IsEnabled() ? ExecuteContext.GetDrawInterface() : nullptr;
 	if (!Hierarchy)
 	{
 		return;
@@ -21,18 +23,24 @@ FRigUnit_ClaviceIK_Execute()
 	{
 		UE_CONTROLRIG_RIGUNIT_REPORT_WARNING(TEXT("Chain has to have length at least 4."));
 	}
+	else if (!ChainCache.Update(Chain, Hierarchy))
+	{
+		UE_CONTROLRIG_RIGUNIT_REPORT_WARNING(TEXT("Chain contains invalid elements."));
+	}
 	else
 	{
+		TArray<FCachedRigElement>& CachedChain = ChainCache.CachedChain;
+
 		// Objective properties
 		const FTransform EndEETarget = GET_IK_OBJECTIVE_TRANSFORM();
 		const FVector EEForwardTarget = GET_IK_OBJECTIVE_FORWARD();
 		const FVector EELocation = EndEETarget.GetLocation();
 
 		// Compute initial leg properties
-		const FTransform InitialClavicle = Hierarchy->GetGlobalTransform(Chain[0]);
-		const FTransform InitialUpperArm = Hierarchy->GetGlobalTransform(Chain[1]);
-		const FTransform InitialLowerArm = Hierarchy->GetGlobalTransform(Chain[2]);
-		const FTransform InitialHand = Hierarchy->GetGlobalTransform(Chain[3]);
+		const FTransform InitialClavicle = Hierarchy->GetGlobalTransform(CachedChain[0]);
+		const FTransform InitialUpperArm = Hierarchy->GetGlobalTransform(CachedChain[1]);
+		const FTransform InitialLowerArm = Hierarchy->GetGlobalTransform(CachedChain[2]);
+		const FTransform InitialHand = Hierarchy->GetGlobalTransform(CachedChain[3]);
 
 		FVector Lengths;
 		Lengths.X = (InitialClavicle.GetLocation() - InitialUpperArm.GetLocation()).Size() * Customisation.X;
@@ -43,8 +51,8 @@ FRigUnit_ClaviceIK_Execute()
 		const FVector InitialHandDelta = InitialHand.GetLocation() - InitialUpperArm.GetLocation();
 
 		// Compute clavicle offset
-		const FTransform Clavicle = Hierarchy->GetGlobalTransform(Chain[0]);
-		const FTransform Shoulder = Hierarchy->GetGlobalTransform(Chain[1]);
+		const FTransform& Clavicle = InitialClavicle;
+		const FTransform& Shoulder = InitialUpperArm;
 		const FVector ClavicleShoulderDelta = Shoulder.GetLocation() - Clavicle.GetLocation();
 		const FVector ClavicleShoulderNormal = ClavicleShoulderDelta.GetSafeNormal();
 		const FVector ClavicleObjectiveDelta = EELocation - Clavicle.GetLocation();
@@ -64,7 +72,7 @@ FRigUnit_ClaviceIK_Execute()
 		const FVector FinalClavicleNormal = ClavicleShoulderNormal * FMath::Sqrt(1.0f - ClavicleSin * ClavicleSin) + ClavicleOrthogonal * ClavicleSin;
 		const FVector ClavicleLocation = Clavicle.GetLocation() + FinalClavicleNormal * Lengths.X;
 
-		if (DebugSettings.bEnabled)
+		if (DebugSettings.IsEnabled())
 		{
 			DrawInterface->DrawLine(FTransform::Identity, Clavicle.GetLocation(), Clavicle.GetLocation() + ClavicleBiasVector * 30.0f, FLinearColor::White, DebugSettings.Scale * 0.5f);
 			DrawInterface->DrawLine(FTransform::Identity, Clavicle.GetLocation(), Clavicle.GetLocation() + ClavicleOrthogonal * 30.0f, FLinearColor::Blue, DebugSettings.Scale * 0.3f);
@@ -88,7 +96,7 @@ FRigUnit_ClaviceIK_Execute()
 		const FVector InitialArmDelta = FVector::VectorPlaneProject(InitialEllbowDelta, InitialHandNormal);
 		const FVector ArmDirection = (ArmRotation * InitialArmDelta).GetSafeNormal();
 
-		if (DebugSettings.bEnabled)
+		if (DebugSettings.IsEnabled())
 		{
 			DrawInterface->DrawLine(FTransform::Identity, ClavicleLocation, ClavicleLocation + ArmDirection * 50.0f, FLinearColor::White, DebugSettings.Scale * 0.5f);
 		}
@@ -98,7 +106,7 @@ FRigUnit_ClaviceIK_Execute()
 		const FVector HandAlignment = EEForwardTarget * (EEAlignment | ObjectiveNormal) - EEAlignment * (EEForwardTarget | ObjectiveNormal);
 		const FVector LowerDirection = FVector::VectorPlaneProject(HandAlignment * Lengths.Z + ArmDirection * Lengths.Y, ObjectiveNormal).GetSafeNormal();
 
-		if (DebugSettings.bEnabled)
+		if (DebugSettings.IsEnabled())
 		{
 			DrawInterface->DrawLine(FTransform::Identity, ObjectiveLocation, ObjectiveLocation + HandAlignment * 30.0f, FLinearColor::Black, DebugSettings.Scale * 0.5f);
 		}
@@ -111,7 +119,7 @@ FRigUnit_ClaviceIK_Execute()
 		const FVector EllbowDelta = ObjectiveNormal * EllbowKath + LowerDirection * EllbowHeight;
 		const FVector EllbowLocation = ClavicleLocation + EllbowDelta;
 
-		if (DebugSettings.bEnabled)
+		if (DebugSettings.IsEnabled())
 		{
 			DrawInterface->DrawLine(FTransform::Identity, EllbowLocation, EllbowLocation + LowerDirection * 20.0f, FLinearColor::Green, DebugSettings.Scale * 0.5f);
 
@@ -121,16 +129,16 @@ FRigUnit_ClaviceIK_Execute()
 		}
 
 		// Transform to propagate along the arm
-		FRigUnit_BendTowards::BendTowards(Chain[0], Chain[1], ClavicleLocation, Hierarchy, ScaleType, PropagateToChildren == EPropagation::All);
-		FRigUnit_BendTowards::BendTowards(Chain[1], Chain[2], EllbowLocation, Hierarchy, ScaleType, PropagateToChildren == EPropagation::All);
-		FRigUnit_BendTowards::BendTowards(Chain[2], Chain[3], ObjectiveLocation, Hierarchy, ScaleType, PropagateToChildren == EPropagation::All);
+		FRigUnit_BendTowards::BendTowards(CachedChain[0], CachedChain[1], ClavicleLocation, Hierarchy, ScaleType, PropagateToChildren == EPropagation::All);
+		FRigUnit_BendTowards::BendTowards(CachedChain[1], CachedChain[2], EllbowLocation, Hierarchy, ScaleType, PropagateToChildren == EPropagation::All);
+		FRigUnit_BendTowards::BendTowards(CachedChain[2], CachedChain[3], ObjectiveLocation, Hierarchy, ScaleType, PropagateToChildren == EPropagation::All);
 
 		// Set foot transform
 		FTransform EE;
-		EE.SetScale3D(Hierarchy->GetInitialGlobalTransform(Chain[3]).GetScale3D());
+		EE.SetScale3D(ChainCache.InitialTransforms[3].GetScale3D());
 		EE.SetRotation(EndEETarget.GetRotation());
 		EE.SetLocation(ObjectiveLocation);
-		Hierarchy->SetGlobalTransform(Chain[3], EE, false, PropagateToChildren != EPropagation::Off);
+		FRigTracedWrite::SetGlobalTransform(Hierarchy, CachedChain[3], EE, false, PropagateToChildren != EPropagation::Off);
 
 		Stretch = ObjectiveDistance / InitialHandDelta.Size();
 	}
@@ -13,30 +13,37 @@ FQuat FRigUnit_ConeFABRIK::SoftRotate(const FTransform& Local, const FTransform&
 	return (FQuat(Rotation.GetRotationAxis(), Angle));
 }
 
-FTransform Fabrik(TArray<FTransform>& Transforms, const TArray<FTransform>& Rest, int32 Index, const FTransform& Forward, const FTransform& Backward, float MaxAngle)
+float FRigUnit_ConeFABRIK::FabrikForward(TArray<FTransform>& Transforms, const TArray<FTransform>& Rest, const FTransform& Forward, const FTransform& Backward, float MaxAngle)
 {
-	if (Index == Rest.Num() - 1)
+	const int32 Num = Transforms.Num();
+	FTransform Transform = Forward;
+	for (int32 Index = 0; Index < Num - 1; Index++)
 	{
-		return Backward;
+		Transforms[Index] = Transform;
+		const FQuat Rotation = FRigUnit_ConeFABRIK::SoftRotate(Rest[Index + 1], Transform, Transforms[Index + 1], MaxAngle);
+		Transform = Rest[Index + 1] * Rotation * Transform;
 	}
+	return (Transform.GetLocation() - Backward.GetLocation()).Size();
+}
 
-	const FTransform Regular = Rest[Index + 1];
-
-	Transforms[Index] = Forward;
-	const FQuat ForwardRotation = FRigUnit_ConeFABRIK::SoftRotate(Regular, Forward, Transforms[Index + 1], MaxAngle);
-
-	const FTransform Transform = Regular * ForwardRotation * Forward;
-	const FTransform Objective = Fabrik(Transforms, Rest, Index + 1, Transform, Backward, MaxAngle);
-
-	Transforms[Index + 1] = Objective;
-	const FQuat BackwardRotation = FRigUnit_ConeFABRIK::SoftRotate(Regular.Inverse(), Objective, Transforms[Index], MaxAngle);
-
-	return Regular.Inverse() * BackwardRotation * Objective;
+void FRigUnit_ConeFABRIK::FabrikBackward(TArray<FTransform>& Transforms, const TArray<FTransform>& RestInverse, const FTransform& Backward, float MaxAngle)
+{
+	const int32 Num = Transforms.Num();
+	FTransform Transform = Backward;
+	for (int32 Index = Num - 2; Index >= 0; Index--)
+	{
+		Transforms[Index + 1] = Transform;
+		const FQuat Rotation = FRigUnit_ConeFABRIK::SoftRotate(RestInverse[Index + 1], Transform, Transforms[Index], MaxAngle);
+		Transform = RestInverse[Index + 1] * Rotation * Transform;
+	}
+	Transforms[0] = Transform;
 }
 
 FRigUnit_ConeFABRIK_Execute()
 {
 	DECLARE_SCOPE_HIERARCHICAL_COUNTER_RIGUNIT();
+	ANGRY_RIGUNIT_TRACE_SCOPE(ConeFABRIK);
+	ANGRY_RIGUNIT_TRACE_COUNT(ChainLength, Chain.Num());
 	URigHierarchy* Hierarchy = ExecuteContext.Hierarchy;
 	if (!Hierarchy)
 	{
@@ -48,34 +55,76 @@ FRigUnit_ConeFABRIK_Execute()
 	{
 		UE_CONTROLRIG_RIGUNIT_REPORT_WARNING(TEXT("Chain has to have length at least 2."));
 	}
+	else if (!ChainCache.Update(Chain, Hierarchy))
+	{
+		UE_CONTROLRIG_RIGUNIT_REPORT_WARNING(TEXT("Chain contains invalid elements."));
+	}
 	else
 	{
-		const FTransform StartEE = Hierarchy->GetGlobalTransform(Chain.First());
+		TArray<FCachedRigElement>& CachedChain = ChainCache.CachedChain;
+
+		const FTransform StartEE = Hierarchy->GetGlobalTransform(CachedChain[0]);
 		const FTransform EndEETarget = GET_IK_OBJECTIVE_TRANSFORM();
 
-		// Populate transform lists
-		TArray<FTransform> Transforms, Rest;
-		Transforms.Reserve(ChainNum);
-		Rest.Reserve(ChainNum);
+		// Populate transform lists (buffers only grow when the chain does)
+		TArray<FTransform>& Transforms = ChainCache.WriteBack.Transforms;
+		TArray<FTransform>& RestInverse = WorkData.RestInverse;
+		const TArray<FTransform>& Rest = ChainCache.InitialTransforms;
+		RestInverse.SetNumUninitialized(ChainNum, false);
 		for (int32 Index = 0; Index < ChainNum; Index++)
 		{
-			Transforms.Emplace(Hierarchy->GetGlobalTransform(Chain[Index]));
-			Rest.Emplace(Hierarchy->GetInitialGlobalTransform(Chain[Index]));
+			Transforms[Index] = Hierarchy->GetGlobalTransform(CachedChain[Index]);
+			RestInverse[Index] = Rest[Index].Inverse();
 		}
 
 		// Objective properties
 		const float MaxRadians = FMath::DegreesToRadians(MaxAngle);
-		for (int32 Iteration = 0; Iteration < Iterations; Iteration++)
+		const int32 LOD = LODSettings.GetLOD(ExecuteContext);
+		const ESolverQuality Quality = LODSettings.GetQuality(LOD);
+		const int32 MaxIterations = LODSettings.ScaleIterations(Iterations, LOD);
+		IterationsUsed = 0;
+
+		if (bWarmStart)
 		{
-			Transforms[0] = Fabrik(Transforms, Rest, 0, StartEE, EndEETarget, MaxRadians);
+			WorkData.WarmStart.Apply(Transforms, StartEE, EndEETarget, ChainCache.Revision, WarmStartThreshold);
 		}
 
-		// Set bones to transforms
-		Hierarchy->SetGlobalTransform(Chain.First(), Transforms[0], false, PropagateToChildren != EPropagation::Off);
-		for (int32 Index = 1; Index < ChainNum - 1; Index++)
+		if (Quality == ESolverQuality::Approximate)
 		{
-			Hierarchy->SetGlobalTransform(Chain[Index], Transforms[Index], false, PropagateToChildren == EPropagation::All);
+			// Rigidly aim the whole chain from its root towards the objective
+			const FVector Root = Transforms[0].GetLocation();
+			const FQuat Rotation = FQuat::FindBetweenVectors(Transforms.Last().GetLocation() - Root, EndEETarget.GetLocation() - Root);
+			for (FTransform& Transform : Transforms)
+			{
+				Transform.SetLocation(Root + Rotation.RotateVector(Transform.GetLocation() - Root));
+				Transform.SetRotation(Rotation * Transform.GetRotation());
+			}
 		}
-		Hierarchy->SetGlobalTransform(Chain.Last(), Transforms.Last(), false, PropagateToChildren != EPropagation::Off);
+
+		while (Quality != ESolverQuality::Approximate && IterationsUsed < MaxIterations)
+		{
+			const float Error = FRigUnit_ConeFABRIK::FabrikForward(Transforms, Rest, StartEE, EndEETarget, MaxRadians);
+			FRigUnit_ConeFABRIK::FabrikBackward(Transforms, RestInverse, EndEETarget, MaxRadians);
+			IterationsUsed++;
+
+			if (Error <= Tolerance)
+			{
+				break;
+			}
+		}
+
+		ANGRY_RIGUNIT_TRACE_COUNT(Iterations, IterationsUsed);
+
+		if (bWarmStart)
+		{
+			WorkData.WarmStart.Store(Transforms, StartEE, EndEETarget, ChainCache.Revision);
+		}
+		else
+		{
+			WorkData.WarmStart.Reset();
+		}
+
+		// Set bones to transforms
+		ChainCache.WriteBack.Commit(Hierarchy, PropagateToChildren);
 	}
 }
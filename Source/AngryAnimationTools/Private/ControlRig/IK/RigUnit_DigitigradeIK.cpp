@@ -10,8 +10,10 @@
 FRigUnit_DigitigradeIK_Execute()
 {
 	DECLARE_SCOPE_HIERARCHICAL_COUNTER_RIGUNIT();
+	ANGRY_RIGUNIT_TRACE_SCOPE(DigitigradeIK);
+	ANGRY_RIGUNIT_TRACE_COUNT(ChainLength, Chain.Num());
 	URigHierarchy* Hierarchy = ExecuteContext.Hierarchy;
-	FRigVMDrawInterface* DrawInterface = ExecuteContext.GetDrawInterface();
+	FRigVMDrawInterface* DrawInterface = DebugSettings.IsEnabled() ? ExecuteContext.GetDrawInterface() : nullptr;
 	if (!Hierarchy)
 	{
 		return;
@@ -21,21 +23,27 @@ FRigUnit_DigitigradeIK_Execute()
 	{
 		UE_CONTROLRIG_RIGUNIT_REPORT_WARNING(TEXT("Chain has to have length at least 4."));
 	}
+	else if (!ChainCache.Update(Chain, Hierarchy))
+	{
+		UE_CONTROLRIG_RIGUNIT_REPORT_WARNING(TEXT("Chain contains invalid elements."));
+	}
 	else
 	{
+		TArray<FCachedRigElement>& CachedChain = ChainCache.CachedChain;
+
 		// Objective properties
 		const FTransform EndEETarget = GET_IK_OBJECTIVE_TRANSFORM();
 		const FVector EEForwardTarget = GET_IK_OBJECTIVE_FORWARD();
 		const FVector EEUpTarget = GET_IK_OBJECTIVE_UP();
 
 		// Compute initial leg properties
-		const FTransform InitialUpperLeg = Hierarchy->GetGlobalTransform(Chain[0]);
-		const FTransform InitialLowerLeg = Hierarchy->GetGlobalTransform(Chain[1]);
-		const FTransform InitialAnkle = Hierarchy->GetGlobalTransform(Chain[2]);
-		const FTransform InitialFoot = Hierarchy->GetGlobalTransform(Chain[3]);
+		const FTransform InitialUpperLeg = Hierarchy->GetGlobalTransform(CachedChain[0]);
+		const FTransform InitialLowerLeg = Hierarchy->GetGlobalTransform(CachedChain[1]);
+		const FTransform InitialAnkle = Hierarchy->GetGlobalTransform(CachedChain[2]);
+		const FTransform InitialFoot = Hierarchy->GetGlobalTransform(CachedChain[3]);
 
 		// Compute objective deltas
-		const FTransform UpperLeg = Hierarchy->GetGlobalTransform(Chain[0]);
+		const FTransform& UpperLeg = InitialUpperLeg;
 		const FVector PelvisLocation = UpperLeg.GetLocation();
 		const FVector ObjectiveDelta = EndEETarget.GetLocation() - PelvisLocation;
 		const float ObjectiveNorm = ObjectiveDelta.Size();
@@ -70,7 +78,7 @@ FRigUnit_DigitigradeIK_Execute()
 		const FVector InitialKneeDirection = FVector::VectorPlaneProject(InitialKneeDelta - InitialAnkleDelta, InitialFootNormal);
 		const FVector LegDirection = (LegRotation * InitialKneeDirection).GetSafeNormal();
 
-		if (DebugSettings.bEnabled)
+		if (DebugSettings.IsEnabled())
 		{
 			DrawInterface->DrawLine(FTransform::Identity, PelvisLocation, PelvisLocation + LegDirection * 50.0f, FLinearColor::White, DebugSettings.Scale * 0.5f);
 		}
@@ -79,7 +87,7 @@ FRigUnit_DigitigradeIK_Execute()
 		const FVector FootDirection = -EEForwardTarget * (EEUpTarget | ObjectiveNormal) + EEUpTarget * (EEForwardTarget | ObjectiveNormal);
 		const FVector LowerDirection = FVector::VectorPlaneProject(FootDirection * (Lengths.X + Lengths.Y) + LegDirection * Lengths.Z * AnkleKneeDirectionWeight, ObjectiveNormal).GetSafeNormal();
 
-		if (DebugSettings.bEnabled)
+		if (DebugSettings.IsEnabled())
 		{
 			DrawInterface->DrawLine(FTransform::Identity, ObjectiveLocation, ObjectiveLocation + FootDirection * 50.0f, FLinearColor::Black, DebugSettings.Scale * 0.5f);
 			DrawInterface->DrawLine(FTransform::Identity, ObjectiveLocation, ObjectiveLocation + EEForwardTarget * 50.0f, FLinearColor::Red, DebugSettings.Scale * 2.5f);
@@ -100,7 +108,7 @@ FRigUnit_DigitigradeIK_Execute()
 		const float UpperDistance = UpperDelta.Size();
 		const FVector UpperNormal = UpperDelta / UpperDistance;
 
-		if (DebugSettings.bEnabled)
+		if (DebugSettings.IsEnabled())
 		{
 			DrawInterface->DrawLine(FTransform::Identity, ObjectiveLocation, ObjectiveLocation + AnkleDelta, FLinearColor::Blue, DebugSettings.Scale * 0.5f);
 		}
@@ -114,7 +122,7 @@ FRigUnit_DigitigradeIK_Execute()
 		const FVector KneeDelta = UpperNormal * KneeKath + UpperDirection * KneeHeight;
 		const FVector KneeLocation = UpperLeg.GetLocation() + KneeDelta;
 
-		if (DebugSettings.bEnabled)
+		if (DebugSettings.IsEnabled())
 		{
 			DrawInterface->DrawLine(FTransform::Identity, KneeLocation, KneeLocation + UpperDirection * 20.0f, FLinearColor::Green, DebugSettings.Scale * 0.5f);
 			DrawInterface->DrawLine(FTransform::Identity, AnkleLocation, AnkleLocation - LowerDirection * 20.0f, FLinearColor::Green, DebugSettings.Scale * 0.5f);
@@ -125,18 +133,18 @@ FRigUnit_DigitigradeIK_Execute()
 		}
 
 		// Transform to propagate along the leg
-		FRigUnit_BendTowards::BendTowards(Chain[0], Chain[1], KneeLocation, Hierarchy, ScaleType, PropagateToChildren == EPropagation::All);
-		FRigUnit_BendTowards::BendTowards(Chain[1], Chain[2], AnkleLocation, Hierarchy, ScaleType, PropagateToChildren == EPropagation::All);
-		FRigUnit_BendTowards::BendTowards(Chain[2], Chain[3], ObjectiveLocation, Hierarchy, ScaleType, PropagateToChildren == EPropagation::All);
+		FRigUnit_BendTowards::BendTowards(CachedChain[0], CachedChain[1], KneeLocation, Hierarchy, ScaleType, PropagateToChildren == EPropagation::All);
+		FRigUnit_BendTowards::BendTowards(CachedChain[1], CachedChain[2], AnkleLocation, Hierarchy, ScaleType, PropagateToChildren == EPropagation::All);
+		FRigUnit_BendTowards::BendTowards(CachedChain[2], CachedChain[3], ObjectiveLocation, Hierarchy, ScaleType, PropagateToChildren == EPropagation::All);
 
 		// Set foot transform
 		FTransform Foot;
-		Foot.SetScale3D(Hierarchy->GetInitialGlobalTransform(Chain[3]).GetScale3D());
+		Foot.SetScale3D(ChainCache.InitialTransforms[3].GetScale3D());
 		Foot.SetRotation(EndEETarget.GetRotation());
 		Foot.SetLocation(ObjectiveLocation);
-		Hierarchy->SetGlobalTransform(Chain[3], Foot, false, PropagateToChildren != EPropagation::Off);
+		FRigTracedWrite::SetGlobalTransform(Hierarchy, CachedChain[3], Foot, false, PropagateToChildren != EPropagation::Off);
 
-		if (DebugSettings.bEnabled)
+		if (DebugSettings.IsEnabled())
 		{
 			DrawInterface->DrawLine(FTransform::Identity, ObjectiveLocation, ObjectiveLocation + EEForwardTarget * 20.0f, FLinearColor::Red, DebugSettings.Scale * 0.5f);
 			DrawInterface->DrawLine(FTransform::Identity, ObjectiveLocation, ObjectiveLocation + EEUpTarget * 20.0f, FLinearColor::Blue, DebugSettings.Scale * 0.5f);
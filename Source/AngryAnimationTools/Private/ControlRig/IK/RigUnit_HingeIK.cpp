@@ -32,11 +32,116 @@ bool FRigUnit_HingeIK::ComputeTriangle(float a, float b, float s, float& h, floa
 	return true;
 }
 
+// Root, target and direction (3 entries each), upper and lower length, resulting hinge location
+static constexpr int32 HingeBatchEntries = 14;
+static constexpr int32 HingeBatchRoot = 0;
+static constexpr int32 HingeBatchTarget = 3;
+static constexpr int32 HingeBatchDirection = 6;
+static constexpr int32 HingeBatchUpper = 9;
+static constexpr int32 HingeBatchLower = 10;
+static constexpr int32 HingeBatchHinge = 11;
+
+FORCEINLINE int32 HingeBatchLane(int32 Index, int32 Entry)
+{
+	return ((Index / 4) * HingeBatchEntries + Entry) * 4 + (Index % 4);
+}
+
+void FHingeIKBatch::Reset(int32 InNum)
+{
+	Num = InNum;
+
+	// Unused lanes have zero lengths and resolve to their root
+	const int32 BlockNum = (Num + 3) / 4;
+	Lanes.SetNumUninitialized(BlockNum * HingeBatchEntries * 4, false);
+	FMemory::Memzero(Lanes.GetData(), Lanes.Num() * sizeof(float));
+}
+
+void FHingeIKBatch::Set(int32 Index, const FVector& Root, const FVector& Target, const FVector& Direction, float UpperLength, float LowerLength)
+{
+	for (int32 Axis = 0; Axis < 3; Axis++)
+	{
+		Lanes[HingeBatchLane(Index, HingeBatchRoot + Axis)] = static_cast<float>(Root[Axis]);
+		Lanes[HingeBatchLane(Index, HingeBatchTarget + Axis)] = static_cast<float>(Target[Axis]);
+		Lanes[HingeBatchLane(Index, HingeBatchDirection + Axis)] = static_cast<float>(Direction[Axis]);
+	}
+
+	Lanes[HingeBatchLane(Index, HingeBatchUpper)] = UpperLength;
+	Lanes[HingeBatchLane(Index, HingeBatchLower)] = LowerLength;
+}
+
+void FHingeIKBatch::Solve()
+{
+	const int32 BlockNum = Lanes.Num() / (HingeBatchEntries * 4);
+	const VectorRegister4Float Zero = VectorZeroFloat();
+	const VectorRegister4Float Quarter = VectorSetFloat1(0.25f);
+	const VectorRegister4Float MinLength = VectorSetFloat1(UE_SMALL_NUMBER);
+
+	for (int32 Block = 0; Block < BlockNum; Block++)
+	{
+		float* Data = Lanes.GetData() + Block * HingeBatchEntries * 4;
+		auto Load = [Data](int32 Entry) { return VectorLoad(Data + Entry * 4); };
+
+		const VectorRegister4Float RootX = Load(HingeBatchRoot + 0), RootY = Load(HingeBatchRoot + 1), RootZ = Load(HingeBatchRoot + 2);
+		const VectorRegister4Float DirX = Load(HingeBatchDirection + 0), DirY = Load(HingeBatchDirection + 1), DirZ = Load(HingeBatchDirection + 2);
+		const VectorRegister4Float A = Load(HingeBatchUpper);
+		const VectorRegister4Float B = Load(HingeBatchLower);
+
+		// Objective direction
+		const VectorRegister4Float DeltaX = VectorSubtract(Load(HingeBatchTarget + 0), RootX);
+		const VectorRegister4Float DeltaY = VectorSubtract(Load(HingeBatchTarget + 1), RootY);
+		const VectorRegister4Float DeltaZ = VectorSubtract(Load(HingeBatchTarget + 2), RootZ);
+		const VectorRegister4Float SS = VectorMax(VectorMultiplyAdd(DeltaZ, DeltaZ, VectorMultiplyAdd(DeltaY, DeltaY, VectorMultiply(DeltaX, DeltaX))), MinLength);
+		const VectorRegister4Float S = VectorSqrt(SS);
+		const VectorRegister4Float InvS = VectorDivide(VectorOneFloat(), S);
+		const VectorRegister4Float NormalX = VectorMultiply(DeltaX, InvS);
+		const VectorRegister4Float NormalY = VectorMultiply(DeltaY, InvS);
+		const VectorRegister4Float NormalZ = VectorMultiply(DeltaZ, InvS);
+
+		// Hinge direction projected onto the objective plane, zero if parallel
+		const VectorRegister4Float Along = VectorMultiplyAdd(DirZ, NormalZ, VectorMultiplyAdd(DirY, NormalY, VectorMultiply(DirX, NormalX)));
+		const VectorRegister4Float PlaneX = VectorNegateMultiplyAdd(Along, NormalX, DirX);
+		const VectorRegister4Float PlaneY = VectorNegateMultiplyAdd(Along, NormalY, DirY);
+		const VectorRegister4Float PlaneZ = VectorNegateMultiplyAdd(Along, NormalZ, DirZ);
+		const VectorRegister4Float PlaneSize = VectorMultiplyAdd(PlaneZ, PlaneZ, VectorMultiplyAdd(PlaneY, PlaneY, VectorMultiply(PlaneX, PlaneX)));
+		const VectorRegister4Float PlaneMask = VectorCompareGT(PlaneSize, MinLength);
+		const VectorRegister4Float InvPlane = VectorSelect(PlaneMask, VectorReciprocalSqrt(VectorMax(PlaneSize, MinLength)), Zero);
+
+		// Same triangle as ComputeTriangle
+		const VectorRegister4Float AA = VectorMultiply(A, A);
+		const VectorRegister4Float BB = VectorMultiply(B, B);
+		const VectorRegister4Float Products = VectorMultiplyAdd(AA, BB, VectorMultiply(SS, VectorAdd(AA, BB)));
+		const VectorRegister4Float Squares = VectorMultiplyAdd(AA, AA, VectorMultiplyAdd(BB, BB, VectorMultiply(SS, SS)));
+		const VectorRegister4Float HH = VectorDivide(VectorMultiply(Quarter, VectorSubtract(VectorAdd(Products, Products), Squares)), SS);
+
+		const VectorRegister4Float Reachable = VectorBitwiseAnd(VectorCompareGE(VectorAdd(A, B), S), VectorCompareGE(HH, Zero));
+		const VectorRegister4Float Sum = VectorAdd(A, B);
+		const VectorRegister4Float Fallback = VectorSelect(VectorCompareGT(Sum, Zero), VectorDivide(VectorMultiply(S, A), VectorMax(Sum, MinLength)), Zero);
+		const VectorRegister4Float X = VectorSelect(Reachable, VectorSqrt(VectorMax(VectorSubtract(AA, HH), Zero)), Fallback);
+		const VectorRegister4Float H = VectorSelect(Reachable, VectorSqrt(VectorMax(HH, Zero)), Zero);
+
+		// Pivot location
+		const VectorRegister4Float Height = VectorMultiply(H, InvPlane);
+		VectorStore(VectorMultiplyAdd(PlaneX, Height, VectorMultiplyAdd(NormalX, X, RootX)), Data + (HingeBatchHinge + 0) * 4);
+		VectorStore(VectorMultiplyAdd(PlaneY, Height, VectorMultiplyAdd(NormalY, X, RootY)), Data + (HingeBatchHinge + 1) * 4);
+		VectorStore(VectorMultiplyAdd(PlaneZ, Height, VectorMultiplyAdd(NormalZ, X, RootZ)), Data + (HingeBatchHinge + 2) * 4);
+	}
+}
+
+FVector FHingeIKBatch::GetHinge(int32 Index) const
+{
+	return FVector(
+		Lanes[HingeBatchLane(Index, HingeBatchHinge + 0)],
+		Lanes[HingeBatchLane(Index, HingeBatchHinge + 1)],
+		Lanes[HingeBatchLane(Index, HingeBatchHinge + 2)]);
+}
+
 FRigUnit_HingeIK_Execute()
 {
 	DECLARE_SCOPE_HIERARCHICAL_COUNTER_RIGUNIT();
+	ANGRY_RIGUNIT_TRACE_SCOPE(HingeIK);
+	ANGRY_RIGUNIT_TRACE_COUNT(ChainLength, Chain.Num());
 	URigHierarchy* Hierarchy = ExecuteContext.Hierarchy;
-	FRigVMDrawInterface* DrawInterface = ExecuteContext.GetDrawInterface();
+	FRigVMDrawInterface* DrawInterface = DebugSettings.IsEnabled() ? ExecuteContext.GetDrawInterface() : nullptr;
 	if (!Hierarchy)
 	{
 		return;
@@ -46,19 +151,23 @@ FRigUnit_HingeIK_Execute()
 	{
 		UE_CONTROLRIG_RIGUNIT_REPORT_WARNING(TEXT("Chain has to have length at least 3."));
 	}
+	else if (!ChainCache.Update(Chain, Hierarchy))
+	{
+		UE_CONTROLRIG_RIGUNIT_REPORT_WARNING(TEXT("Chain contains invalid elements."));
+	}
 	else
 	{
+		TArray<FCachedRigElement>& CachedChain = ChainCache.CachedChain;
+
 		// Objective properties
 		const FTransform EndEETarget = GET_IK_OBJECTIVE_TRANSFORM();
 
 		// Compute initial leg properties
-		const FTransform InitialUpper = Hierarchy->GetInitialGlobalTransform(Chain[0]);
-		const FTransform InitialLower = Hierarchy->GetInitialGlobalTransform(Chain[1]);
-		const FTransform InitialEE = Hierarchy->GetInitialGlobalTransform(Chain[2]);
+		const FTransform& InitialEE = ChainCache.InitialTransforms[2];
 
 		FVector2D InitialLengths;
-		InitialLengths.X = (InitialUpper.GetLocation() - InitialLower.GetLocation()).Size() * Customisation.X;
-		InitialLengths.Y = (InitialLower.GetLocation() - InitialEE.GetLocation()).Size() * Customisation.Y;
+		InitialLengths.X = ChainCache.InitialLengths[0] * Customisation.X;
+		InitialLengths.Y = ChainCache.InitialLengths[1] * Customisation.Y;
 
 		// Rescale to fit length
 		float ChainMaxLength = InitialLengths.X + InitialLengths.Y;
@@ -71,9 +180,8 @@ FRigUnit_HingeIK_Execute()
 		}
 
 		// Compute objective deltas
-		FTransform Upper = Hierarchy->GetGlobalTransform(Chain[0]);
-		FTransform Lower = Hierarchy->GetGlobalTransform(Chain[1]);
-		FTransform EE = Hierarchy->GetGlobalTransform(Chain[2]);
+		FTransform Upper = Hierarchy->GetGlobalTransform(CachedChain[0]);
+		FTransform EE = Hierarchy->GetGlobalTransform(CachedChain[2]);
 		const FVector ObjectiveDelta = Objective.GetLocation() - Upper.GetLocation();
 		const float ObjectiveNorm = ObjectiveDelta.Size();
 		const FVector ObjectiveNormal = ObjectiveDelta / ObjectiveNorm;
@@ -87,7 +195,7 @@ FRigUnit_HingeIK_Execute()
 
 		const FVector HingeLocation = Upper.GetLocation() + ObjectiveNormal * Kath + HingeDirection * Height;
 
-		if (DebugSettings.bEnabled)
+		if (DebugSettings.IsEnabled())
 		{
 			const FVector Location = Upper.GetLocation() + ObjectiveNormal * Kath;
 			DrawInterface->DrawLine(FTransform::Identity, Location, HingeLocation, FLinearColor::Yellow, DebugSettings.Scale);
@@ -95,13 +203,13 @@ FRigUnit_HingeIK_Execute()
 		}
 
 		// Transform to propagate along the hinge
-		FRigUnit_BendTowards::BendTowards(Chain[0], Chain[1], HingeLocation, Hierarchy, ScaleType, PropagateToChildren == EPropagation::All);
-		FRigUnit_BendTowards::BendTowards(Chain[1], Chain[2], Objective.GetLocation(), Hierarchy, ScaleType, PropagateToChildren == EPropagation::All);
+		FRigUnit_BendTowards::BendTowards(CachedChain[0], CachedChain[1], HingeLocation, Hierarchy, ScaleType, PropagateToChildren == EPropagation::All);
+		FRigUnit_BendTowards::BendTowards(CachedChain[1], CachedChain[2], Objective.GetLocation(), Hierarchy, ScaleType, PropagateToChildren == EPropagation::All);
 
 		// Set foot transform
 		EE.SetRotation(EndEETarget.GetRotation());
 		EE.SetScale3D(InitialEE.GetScale3D());
 		EE.SetLocation(Objective.GetLocation());
-		Hierarchy->SetGlobalTransform(Chain[2], EE, false, PropagateToChildren != EPropagation::Off);
+		FRigTracedWrite::SetGlobalTransform(Hierarchy, CachedChain[2], EE, false, PropagateToChildren != EPropagation::Off);
 	}
 }
\ No newline at end of file
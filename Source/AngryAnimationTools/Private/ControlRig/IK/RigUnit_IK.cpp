@@ -1,4 +1,98 @@
 
 
 #include "ControlRig/IK/RigUnit_IK.h"
-#include "ControlRig.h"
\ No newline at end of file
+#include "ControlRig.h"
+
+bool FRigWarmStart::Apply(TArray<FTransform>& Transforms, const FTransform& Root, const FTransform& Objective, int32 InRevision, float Threshold) const
+{
+	if (Revision != InRevision || Relative.Num() != Transforms.Num())
+	{
+		return false;
+	}
+
+	// Objective is compared in root space so regular root motion doesn't cause a cold start
+	const float ThresholdSquared = Threshold * Threshold;
+	const FVector ObjectiveDelta = Root.InverseTransformPosition(Objective.GetLocation()) - PreviousObjective;
+	if (FVector::DistSquared(Root.GetLocation(), PreviousRoot.GetLocation()) > ThresholdSquared || ObjectiveDelta.SizeSquared() > ThresholdSquared)
+	{
+		return false;
+	}
+
+	const int32 Num = Transforms.Num();
+	for (int32 Index = 0; Index < Num; Index++)
+	{
+		Transforms[Index] = Relative[Index] * Root;
+	}
+	return true;
+}
+
+void FRigWarmStart::Store(const TArray<FTransform>& Transforms, const FTransform& Root, const FTransform& Objective, int32 InRevision)
+{
+	const int32 Num = Transforms.Num();
+	Relative.SetNumUninitialized(Num, false);
+	for (int32 Index = 0; Index < Num; Index++)
+	{
+		Relative[Index] = Transforms[Index].GetRelativeTransform(Root);
+	}
+
+	PreviousRoot = Root;
+	PreviousObjective = Root.InverseTransformPosition(Objective.GetLocation());
+	Revision = InRevision;
+}
+
+void FRigWarmStart::Reset()
+{
+	Revision = INDEX_NONE;
+}
+
+bool FRigUnit_IK_WorkData::Update(const FRigElementKeyCollection& Chain, const URigHierarchy* Hierarchy)
+{
+	const int32 ChainNum = Chain.Num();
+	if (TopologyVersion == Hierarchy->GetTopologyVersion() && CachedChain.Num() == ChainNum)
+	{
+		// Only need to make sure the input chain didn't change
+		bool bMatches = true;
+		for (int32 Index = 0; Index < ChainNum && bMatches; Index++)
+		{
+			bMatches = CachedChain[Index].GetKey() == Chain[Index];
+		}
+
+		if (bMatches)
+		{
+			return bIsValid;
+		}
+	}
+
+	TopologyVersion = Hierarchy->GetTopologyVersion();
+	bIsValid = true;
+	Revision++;
+
+	CachedChain.SetNum(ChainNum);
+	InitialTransforms.SetNum(ChainNum);
+	InitialDeltas.SetNum(ChainNum);
+	InitialLengths.SetNum(FMath::Max(ChainNum - 1, 0));
+	InitialChainLength = 0.0f;
+
+	for (int32 Index = 0; Index < ChainNum; Index++)
+	{
+		FCachedRigElement& Cache = CachedChain[Index];
+		Cache.Reset();
+		if (!Cache.UpdateCache(Chain[Index], Hierarchy))
+		{
+			bIsValid = false;
+			continue;
+		}
+
+		InitialTransforms[Index] = Hierarchy->GetGlobalTransform(Cache, true);
+		InitialDeltas[Index] = InitialTransforms[Index].GetLocation() - InitialTransforms[0].GetLocation();
+		if (Index > 0)
+		{
+			const float Length = (InitialTransforms[Index].GetLocation() - InitialTransforms[Index - 1].GetLocation()).Size();
+			InitialLengths[Index - 1] = Length;
+			InitialChainLength += Length;
+		}
+	}
+
+	WriteBack.Prepare(CachedChain, Hierarchy);
+	return bIsValid;
+}
@@ -9,8 +9,10 @@
 FRigUnit_NeckIK_Execute()
 {
 	DECLARE_SCOPE_HIERARCHICAL_COUNTER_RIGUNIT();
+	ANGRY_RIGUNIT_TRACE_SCOPE(NeckIK);
+	ANGRY_RIGUNIT_TRACE_COUNT(ChainLength, Chain.Num());
 	URigHierarchy* Hierarchy = ExecuteContext.Hierarchy;
-	FRigVMDrawInterface* DrawInterface = ExecuteContext.GetDrawInterface();
+	FRigVMDrawInterface* DrawInterface = DebugSettings.IsEnabled() ? ExecuteContext.GetDrawInterface() : nullptr;
 	if (!Hierarchy)
 	{
 		return;
@@ -21,13 +23,19 @@ FRigUnit_NeckIK_Execute()
 	{
 		UE_CONTROLRIG_RIGUNIT_REPORT_WARNING(TEXT("Chain has to have length at least 2."));
 	}
+	else if (!ChainCache.Update(Chain, Hierarchy))
+	{
+		UE_CONTROLRIG_RIGUNIT_REPORT_WARNING(TEXT("Chain contains invalid elements."));
+	}
 	else
 	{
+		TArray<FCachedRigElement>& CachedChain = ChainCache.CachedChain;
+
 		// Objective properties
 		const FTransform EndEETarget = GET_IK_OBJECTIVE_TRANSFORM();
 		const FVector EEUpTarget = GET_IK_OBJECTIVE_UP();
 
-		const FTransform Last = Hierarchy->GetGlobalTransform(Chain.Last());
+		const FTransform Last = Hierarchy->GetGlobalTransform(CachedChain.Last());
 		const FVector TargetDirection = (EndEETarget.GetLocation() - Last.GetLocation()).GetSafeNormal();
 		const FVector CurrentForward = Last.TransformVectorNoScale(EndeffectorForward);
 		const FVector CurrentUp = Last.TransformVectorNoScale(EndeffectorUp);
@@ -44,34 +52,36 @@ FRigUnit_NeckIK_Execute()
 		const float TwistAngle = FRigUnit_SoftLimitValue::SoftLimit(FMath::Acos(TwistUpAxis | EEUpTarget), FMath::DegreesToRadians(TwistAngleLimit));
 		const FQuat TwistSegment = FQuat(TwistAxis, TwistAngle * Intensity / (ChainNum - 1));
 
-		if (DebugSettings.bEnabled)
+		if (DebugSettings.IsEnabled())
 		{
-			const FTransform First = Hierarchy->GetGlobalTransform(Chain.First());
+			const FTransform First = Hierarchy->GetGlobalTransform(CachedChain[0]);
 			DrawInterface->DrawLine(FTransform::Identity, First.GetLocation(), First.GetLocation() + TwistUpAxis * 20.0f, FLinearColor::Red, DebugSettings.Scale * 0.2f);
 			DrawInterface->DrawLine(FTransform::Identity, First.GetLocation(), First.GetLocation() + EEUpTarget * 20.0f, FLinearColor::Green, DebugSettings.Scale * 0.2f);
 			DrawInterface->DrawLine(FTransform::Identity, First.GetLocation(), First.GetLocation() + TwistAxis * 20.0f, FLinearColor::Blue, DebugSettings.Scale * 0.5f);
 		}
 
 		// Apply rotation along the whole chain
-		FTransform Transform = Hierarchy->GetGlobalTransform(Chain[0]);
+		TArray<FTransform>& Transforms = ChainCache.WriteBack.Transforms;
+		FTransform Transform = Hierarchy->GetGlobalTransform(CachedChain[0]);
 		for (int32 Index = 1; Index < ChainNum; Index++)
 		{
-			const FTransform Local = Hierarchy->GetLocalTransform(Chain[Index]);
+			const FTransform Local = ChainCache.WriteBack.GetLocalTransform(Hierarchy, Index);
 
 			// Rotate segment along forward axis according to how much they are aligned to roll axis
 			Transform.SetRotation(TwistSegment * BendSegment * Transform.GetRotation());
 
 			// Update chain element (no update needed since we propagate everything later)
-			Hierarchy->SetGlobalTransform(Chain[Index - 1], Transform, false, false);
+			Transforms[Index - 1] = Transform;
 
 			// Propagate to next in line and store delta for fabrik
 			Transform = Local * Transform;
 		}
 
 		// Set EE transform
-		Hierarchy->SetGlobalTransform(Chain.Last(), Transform, false, PropagateToChildren != EPropagation::Off);
+		Transforms.Last() = Transform;
+		ChainCache.WriteBack.Commit(Hierarchy, PropagateToChildren);
 
-		if (DebugSettings.bEnabled)
+		if (DebugSettings.IsEnabled())
 		{
 			DrawInterface->DrawLine(FTransform::Identity, Transform.GetLocation(), Transform.GetLocation() + EEUpTarget * 20.0f, FLinearColor::Blue, DebugSettings.Scale * 0.5f);
 		}
@@ -7,10 +7,8 @@
 #include "ControlRig.h"
 #include "Units/RigUnitContext.h"
 
-void WeightedMean(const FControlRigExecuteContext& ExecuteContext, const FDebugSettings& DebugSettings, TArray<FTransform>& Transforms, const TArray<FTransform>& A, const TArray<FTransform>& B, float Bias)
+void WeightedMean(FRigDebugBuffer* Debug, const FDebugSettings& DebugSettings, TArray<FTransform>& Transforms, const TArray<FTransform>& A, const TArray<FTransform>& B, float Bias)
 {
-	FRigVMDrawInterface* DrawInterface = ExecuteContext.GetDrawInterface();
-
 	// Both ends always match
 	Transforms[0] = A[0];
 	Transforms.Last() = B.Last();
@@ -23,9 +21,9 @@ void WeightedMean(const FControlRigExecuteContext& ExecuteContext, const FDebugS
 		const float Weight = FMath::Lerp(FMath::Square(Ratio), 1.0f - FMath::Square(1.0f - Ratio), Bias);
 		Transforms[Index].Blend(A[Index], B[Index], Weight);
 
-		if (DebugSettings.bEnabled)
+		if (Debug)
 		{
-			DrawInterface->DrawPoint(FTransform::Identity, Transforms[Index].GetLocation(), DebugSettings.Scale * 5.0f, FLinearColor::Yellow);
+			Debug->AddPoint(Transforms[Index].GetLocation(), DebugSettings.Scale * 5.0f, FLinearColor::Yellow);
 		}
 	}
 }
@@ -43,32 +41,38 @@ void Straighten(TArray<FTransform>& Transforms, const TArray<FTransform>& Rest)
 }
 
 void InitialiseBendTransforms(
-	const FControlRigExecuteContext& ExecuteContext,
+	URigHierarchy* Hierarchy,
+	FRigDebugBuffer* Debug,
 	const FDebugSettings& DebugSettings,
-	const FRigElementKeyCollection& Chain,
+	TArray<FCachedRigElement>& CachedChain,
+	const FRigChainWriteBack& WriteBack,
 	const FTransform& StartEE, const FVector& StartOffset, float StartRadius,
 	const FTransform& EndEETarget, const FVector& EndOffset, float EndRadius,
-	TArray<FTransform>& Rest,
-	TArray<FTransform>& StartChain,
-	TArray<FTransform>& EndChain,
+	FRigUnit_SpineIK_WorkData& WorkData,
 	TArray<FTransform>& Transforms)
 {
-	FRigVMDrawInterface* DrawInterface = ExecuteContext.GetDrawInterface();
-	URigHierarchy* Hierarchy = ExecuteContext.Hierarchy;
-	const int32 ChainNum = Chain.Num();
-
-	// Populate transform lists
-	Rest.Reserve(ChainNum);
-	StartChain.Reserve(ChainNum);
-	EndChain.Reserve(ChainNum);
-	Transforms.Reserve(ChainNum);
+	const int32 ChainNum = CachedChain.Num();
+
+	TArray<FTransform>& Rest = WorkData.Rest;
+	TArray<FTransform>& StartChain = WorkData.StartChain;
+	TArray<FTransform>& EndChain = WorkData.EndChain;
+
+	// Populate transform lists, buffers only ever grow so there is no allocation once warmed up
+	Rest.SetNumUninitialized(ChainNum, false);
+	WorkData.RestInverse.SetNumUninitialized(ChainNum, false);
+	WorkData.RestLengths.SetNumUninitialized(ChainNum, false);
+	StartChain.SetNumUninitialized(ChainNum, false);
+	EndChain.SetNumUninitialized(ChainNum, false);
+	Transforms.SetNumUninitialized(ChainNum, false);
 	for (int32 Index = 0; Index < ChainNum; Index++)
 	{
-		//Rest.Emplace(ExecuteContext.Hierarchy->GetInitialLocalTransform(Chain[Index]));
-		Rest.Emplace(Hierarchy->GetLocalTransform(Chain[Index]));
-		Transforms.Emplace(Hierarchy->GetGlobalTransform(Chain[Index]));
-		StartChain.Emplace(StartEE);
-		EndChain.Emplace(EndEETarget);
+		//Rest[Index] = ExecuteContext.Hierarchy->GetInitialLocalTransform(Chain[Index]);
+		Rest[Index] = WriteBack.GetLocalTransform(Hierarchy, Index);
+		WorkData.RestInverse[Index] = Rest[Index].Inverse();
+		WorkData.RestLengths[Index] = Rest[Index].GetLocation().Size();
+		Transforms[Index] = Hierarchy->GetGlobalTransform(CachedChain[Index]);
+		StartChain[Index] = StartEE;
+		EndChain[Index] = EndEETarget;
 	}
 
 	const FQuat StartOffsetRotation = FQuat(StartOffset.GetSafeNormal(), FMath::DegreesToRadians(StartOffset.Size()));
@@ -83,20 +87,18 @@ void InitialiseBendTransforms(
 	for (int32 Index = 1; Index < ChainNum; Index++)
 	{
 		StartChain[Index] = Rest[Index] * StartChain[Index - 1];
-		EndChain[ChainNum - Index - 1] = Rest[ChainNum - Index].Inverse() * EndChain[ChainNum - Index];
+		EndChain[ChainNum - Index - 1] = WorkData.RestInverse[ChainNum - Index] * EndChain[ChainNum - Index];
 
-		if (DebugSettings.bEnabled)
+		if (Debug)
 		{
-			DrawInterface->DrawPoint(FTransform::Identity, StartChain[Index].GetLocation(), DebugSettings.Scale * 5.0f, FLinearColor::Red);
-			DrawInterface->DrawPoint(FTransform::Identity, EndChain[ChainNum - Index - 1].GetLocation(), DebugSettings.Scale * 5.0f, FLinearColor::Blue);
+			Debug->AddPoint(StartChain[Index].GetLocation(), DebugSettings.Scale * 5.0f, FLinearColor::Red);
+			Debug->AddPoint(EndChain[ChainNum - Index - 1].GetLocation(), DebugSettings.Scale * 5.0f, FLinearColor::Blue);
 		}
 	}
 }
 
-void ChainForwardSolve(const FControlRigExecuteContext& ExecuteContext, const FDebugSettings& DebugSettings, const TArray<FTransform>& Rest, const TArray<FTransform>& Transforms, TArray<FTransform>& StartChain, float MaxAnchorRadians)
+void ChainForwardSolve(FRigDebugBuffer* Debug, const FDebugSettings& DebugSettings, const TArray<FTransform>& Rest, const TArray<FTransform>& Transforms, TArray<FTransform>& StartChain, float MaxAnchorRadians)
 {
-	FRigVMDrawInterface* DrawInterface = ExecuteContext.GetDrawInterface();
-
 	const int32 ChainNum = Rest.Num();
 	for (int32 Index = 1; Index < ChainNum; Index++)
 	{
@@ -107,31 +109,33 @@ void ChainForwardSolve(const FControlRigExecuteContext& ExecuteContext, const FD
 		const FQuat Rotation = FRigUnit_ConeFABRIK::SoftRotate(Regular, StartChain[Index - 1], Transforms[Index], MaxAnchorRadians);
 		StartChain[Index] = Regular * Rotation * StartChain[Index - 1];
 
-		if (DebugSettings.bEnabled)
+		if (Debug)
 		{
-			DrawInterface->DrawPoint(FTransform::Identity, StartChain[Index].GetLocation(), DebugSettings.Scale * 7.5f, FLinearColor::White);
+			Debug->AddPoint(StartChain[Index].GetLocation(), DebugSettings.Scale * 7.5f, FLinearColor::White);
 		}
 	}
 }
 
-void ChainBackwardSolve(const FControlRigExecuteContext& ExecuteContext, const FDebugSettings& DebugSettings, const TArray<FTransform>& Rest, const TArray<FTransform>& Transforms, TArray<FTransform>& EndChain, float MaxObjectiveRadians)
+void ChainBackwardSolve(FRigDebugBuffer* Debug, const FDebugSettings& DebugSettings, const TArray<FTransform>& RestInverse, const TArray<float>& RestLengths, const TArray<FTransform>& Transforms, TArray<FTransform>& EndChain, float MaxObjectiveRadians)
 {
-	FRigVMDrawInterface* DrawInterface = ExecuteContext.GetDrawInterface();
-
-	const int32 ChainNum = Rest.Num();
+	const int32 ChainNum = RestInverse.Num();
 	for (int32 Index = ChainNum - 1; Index >= 1; Index--)
 	{
-		FTransform Regular = Rest[Index];
+		// Inverse translation is linear in the rest translation, so clamping can be applied to the cached inverse directly
+		FTransform RegularInv = RestInverse[Index];
 		const float RegularDistance = (Transforms[Index].GetLocation() - Transforms[Index - 1].GetLocation()).Size();
-		Regular.SetLocation(Regular.GetLocation().GetClampedToMaxSize(RegularDistance));
+		if (RestLengths[Index] > RegularDistance)
+		{
+			const float Ratio = RegularDistance < UE_KINDA_SMALL_NUMBER ? 0.0f : RegularDistance / RestLengths[Index];
+			RegularInv.SetTranslation(RegularInv.GetTranslation() * Ratio);
+		}
 
-		const FTransform& RegularInv = Regular.Inverse();
 		const FQuat Rotation = FRigUnit_ConeFABRIK::SoftRotate(RegularInv, EndChain[Index], Transforms[Index - 1], MaxObjectiveRadians);
 		EndChain[Index - 1] = RegularInv * Rotation * EndChain[Index];
 
-		if (DebugSettings.bEnabled)
+		if (Debug)
 		{
-			DrawInterface->DrawPoint(FTransform::Identity, EndChain[Index - 1].GetLocation(), DebugSettings.Scale * 7.5f, FLinearColor::Black);
+			Debug->AddPoint(EndChain[Index - 1].GetLocation(), DebugSettings.Scale * 7.5f, FLinearColor::Black);
 		}
 	}
 }
@@ -139,6 +143,8 @@ void ChainBackwardSolve(const FControlRigExecuteContext& ExecuteContext, const F
 FRigUnit_SpineIK_Execute()
 {
 	DECLARE_SCOPE_HIERARCHICAL_COUNTER_RIGUNIT();
+	ANGRY_RIGUNIT_TRACE_SCOPE(SpineIK);
+	ANGRY_RIGUNIT_TRACE_COUNT(ChainLength, Chain.Num());
 	URigHierarchy* Hierarchy = ExecuteContext.Hierarchy;
 	if (!Hierarchy)
 	{
@@ -150,32 +156,58 @@ FRigUnit_SpineIK_Execute()
 	{
 		UE_CONTROLRIG_RIGUNIT_REPORT_WARNING(TEXT("Chain has to have length at least 2."));
 	}
+	else if (!ChainCache.Update(Chain, Hierarchy))
+	{
+		UE_CONTROLRIG_RIGUNIT_REPORT_WARNING(TEXT("Chain contains invalid elements."));
+	}
 	else
 	{
+		TArray<FCachedRigElement>& CachedChain = ChainCache.CachedChain;
+
 		// Objective properties
-		const FTransform StartEE = ExecuteContext.Hierarchy->GetGlobalTransform(Chain.First());
+		const FTransform StartEE = Hierarchy->GetGlobalTransform(CachedChain[0]);
 		const FTransform EndEETarget = GET_IK_OBJECTIVE_TRANSFORM();
 
-		TArray<FTransform> Rest, StartChain, EndChain, Transforms;
-		InitialiseBendTransforms(ExecuteContext, DebugSettings, Chain, 
+		// Distant characters iterate less, the approximation only blends both initial chains
+		const int32 LOD = LODSettings.GetLOD(ExecuteContext);
+		const ESolverQuality Quality = LODSettings.GetQuality(LOD);
+		const int32 SolveIterations = Quality == ESolverQuality::Approximate ? 0 : LODSettings.ScaleIterations(Iterations, LOD);
+
+		// Only record debug primitives if enabled
+		FRigDebugBuffer* Debug = DebugSettings.IsEnabled() && Quality == ESolverQuality::Full ? &ChainCache.DebugBuffer : nullptr;
+
+		TArray<FTransform>& Transforms = ChainCache.WriteBack.Transforms;
+		InitialiseBendTransforms(Hierarchy, Debug, DebugSettings, CachedChain, ChainCache.WriteBack,
 			StartEE, ObjectiveSettings.LimitBias, ObjectiveSettings.LimitRadius, 
 			EndEETarget, AnchorSettings.LimitBias, AnchorSettings.LimitRadius, 
-			Rest, StartChain, EndChain, Transforms);
+			WorkData, Transforms);
+
+		const TArray<FTransform>& Rest = WorkData.Rest;
+		TArray<FTransform>& StartChain = WorkData.StartChain;
+		TArray<FTransform>& EndChain = WorkData.EndChain;
 
 		// Collapse start and end chain into one
-		WeightedMean(ExecuteContext, DebugSettings, Transforms, StartChain, EndChain, 0.0f);
+		WeightedMean(Debug, DebugSettings, Transforms, StartChain, EndChain, 0.0f);
+
+		// Replace the blended guess with last frame's solution, ends are always given by the effectors
+		if (bWarmStart && WorkData.WarmStart.Apply(Transforms, StartEE, EndEETarget, ChainCache.Revision, WarmStartThreshold))
+		{
+			Transforms[0] = StartChain[0];
+			Transforms.Last() = EndChain.Last();
+		}
 
 		const float MaxAnchorRadians = FMath::DegreesToRadians(AnchorSettings.AngleLimit);
 		const float MaxObjectiveRadians = FMath::DegreesToRadians(ObjectiveSettings.AngleLimit);
-		for (int32 Iteration = 0; Iteration < Iterations; Iteration++)
+		for (int32 Iteration = 0; Iteration < SolveIterations; Iteration++)
 		{
 			// Apply one FABRIK iteration to both directions
-			ChainForwardSolve(ExecuteContext, DebugSettings, Rest, Transforms, StartChain, MaxAnchorRadians);
-			ChainBackwardSolve(ExecuteContext, DebugSettings, Rest, Transforms, EndChain, MaxObjectiveRadians);
+			ChainForwardSolve(Debug, DebugSettings, Rest, Transforms, StartChain, MaxAnchorRadians);
+			ChainBackwardSolve(Debug, DebugSettings, WorkData.RestInverse, WorkData.RestLengths, Transforms, EndChain, MaxObjectiveRadians);
 
 			// Collapse both FABRIK iterations into one
-			WeightedMean(ExecuteContext, DebugSettings, Transforms, StartChain, EndChain, 1.0f);
+			WeightedMean(Debug, DebugSettings, Transforms, StartChain, EndChain, 1.0f);
 		}
+		ANGRY_RIGUNIT_TRACE_COUNT(Iterations, SolveIterations);
 
 		// Make sure all bones are properly rotated
 		Straighten(Transforms, Rest);
@@ -183,12 +215,21 @@ FRigUnit_SpineIK_Execute()
 		Transforms[0] = StartEE;
 		Transforms.Last() = EndEETarget;
 
+		if (bWarmStart)
+		{
+			WorkData.WarmStart.Store(Transforms, StartEE, EndEETarget, ChainCache.Revision);
+		}
+		else
+		{
+			WorkData.WarmStart.Reset();
+		}
+
 		// Set bones to transforms
-		Hierarchy->SetGlobalTransform(Chain[0], Transforms[0], false, PropagateToChildren != EPropagation::Off);
-		for (int32 Index = 1; Index < ChainNum - 1; Index++)
+		ChainCache.WriteBack.Commit(Hierarchy, PropagateToChildren);
+
+		if (Debug)
 		{
-			Hierarchy->SetGlobalTransform(Chain[Index], Transforms[Index], false, PropagateToChildren == EPropagation::All);
+			Debug->Flush(ExecuteContext.GetDrawInterface());
 		}
-		Hierarchy->SetGlobalTransform(Chain.Last(), Transforms.Last(), false, PropagateToChildren != EPropagation::Off);
 	}
 }
\ No newline at end of file
@@ -0,0 +1,275 @@
+#include "ControlRig/IK/RigUnit_SplineIK.h"
+#include "ControlRig/RigUnit_BendTowards.h"
+
+#include "ControlRig.h"
+#include "Units/RigUnitContext.h"
+
+FVector FRigUnit_SplineIK_WorkData::Evaluate(int32 Segment, float Alpha) const
+{
+	const int32 KeyNum = Points.Num();
+	const FVector& P1 = Points[Segment];
+	const FVector& P2 = Points[Segment + 1];
+
+	// Mirror neighbours at the ends of the spline
+	const FVector P0 = Segment > 0 ? Points[Segment - 1] : P1 * 2.0f - P2;
+	const FVector P3 = Segment + 2 < KeyNum ? Points[Segment + 2] : P2 * 2.0f - P1;
+
+	const float Alpha2 = Alpha * Alpha;
+	const float Alpha3 = Alpha2 * Alpha;
+	return 0.5f * (
+		(P1 * 2.0f) +
+		(P2 - P0) * Alpha +
+		(P0 * 2.0f - P1 * 5.0f + P2 * 4.0f - P3) * Alpha2 +
+		(P1 * 3.0f - P0 - P2 * 3.0f + P3) * Alpha3);
+}
+
+FVector FRigUnit_SplineIK_WorkData::Derivative(int32 Segment, float Alpha) const
+{
+	const int32 KeyNum = Points.Num();
+	const FVector& P1 = Points[Segment];
+	const FVector& P2 = Points[Segment + 1];
+	const FVector P0 = Segment > 0 ? Points[Segment - 1] : P1 * 2.0f - P2;
+	const FVector P3 = Segment + 2 < KeyNum ? Points[Segment + 2] : P2 * 2.0f - P1;
+
+	return 0.5f * (
+		(P2 - P0) +
+		(P0 * 2.0f - P1 * 5.0f + P2 * 4.0f - P3) * (2.0f * Alpha) +
+		(P1 * 3.0f - P0 - P2 * 3.0f + P3) * (3.0f * Alpha * Alpha));
+}
+
+float FRigUnit_SplineIK_WorkData::Integrate(int32 Segment, float From, float To) const
+{
+	// 5 point Gauss-Legendre quadrature of the tangent length
+	static const float Nodes[5] = { 0.0f, -0.5384693101f, 0.5384693101f, -0.9061798459f, 0.9061798459f };
+	static const float Weights[5] = { 0.5688888889f, 0.4786286705f, 0.4786286705f, 0.2369268851f, 0.2369268851f };
+
+	const float Half = (To - From) * 0.5f;
+	const float Center = (To + From) * 0.5f;
+	float Length = 0.0f;
+	for (int32 Node = 0; Node < 5; Node++)
+	{
+		Length += Weights[Node] * Derivative(Segment, Center + Half * Nodes[Node]).Size();
+	}
+	return Length * Half;
+}
+
+void FRigUnit_SplineIK_WorkData::Update(const FRigUnit_IK_WorkData& ChainCache, float PositionAlongSpline, int32 Iterations)
+{
+	const int32 KeyNum = Points.Num();
+	const int32 SegmentNum = KeyNum - 1;
+	const int32 ChainNum = ChainCache.CachedChain.Num();
+
+	// Bone ratios only depend on rest lengths, previous parameters are meaningless if the spline layout changed
+	bool bWarmStart = true;
+	if (CachedRevision != ChainCache.Revision || CachedKeyNum != KeyNum || CachedPositionAlongSpline != PositionAlongSpline || BoneRatios.Num() != ChainNum)
+	{
+		CachedRevision = ChainCache.Revision;
+		CachedKeyNum = KeyNum;
+		CachedPositionAlongSpline = PositionAlongSpline;
+		bWarmStart = false;
+
+		BoneRatios.SetNumUninitialized(ChainNum, false);
+		BoneSegments.SetNumUninitialized(ChainNum, false);
+		BoneAlphas.SetNumUninitialized(ChainNum, false);
+
+		const float RatioScale = PositionAlongSpline / ChainCache.InitialChainLength;
+		float Distance = 0.0f;
+		for (int32 Index = 0; Index < ChainNum; Index++)
+		{
+			if (Index > 0)
+			{
+				Distance += ChainCache.InitialLengths[Index - 1];
+			}
+			BoneRatios[Index] = Distance * RatioScale;
+		}
+	}
+
+	SegmentLengths.SetNumUninitialized(SegmentNum, false);
+	float Length = 0.0f;
+	for (int32 Segment = 0; Segment < SegmentNum; Segment++)
+	{
+		SegmentLengths[Segment] = Integrate(Segment, 0.0f, 1.0f);
+		Length += SegmentLengths[Segment];
+	}
+
+	// Bones are sorted along the spline, so segments are walked once and each bone integrates from the one before
+	const int32 Steps = FMath::Max(Iterations, 1) + (bWarmStart ? 0 : 4);
+	int32 Segment = 0;
+	float SegmentStart = 0.0f;
+	float BaseAlpha = 0.0f;
+	float BaseDistance = 0.0f;
+	for (int32 Index = 0; Index < ChainNum; Index++)
+	{
+		// Going past the spline ends extrapolates linearly in parameter space
+		const float Ratio = BoneRatios[Index];
+		const float ArcDistance = Ratio * Length;
+		if (FMath::IsNearlyZero(Length) || ArcDistance <= 0.0f || ArcDistance >= Length)
+		{
+			const float Parameter = Ratio * SegmentNum;
+			BoneSegments[Index] = FMath::Clamp(FMath::FloorToInt(Parameter), 0, SegmentNum - 1);
+			BoneAlphas[Index] = Parameter - BoneSegments[Index];
+			continue;
+		}
+
+		while (Segment < SegmentNum - 1 && SegmentStart + SegmentLengths[Segment] < ArcDistance)
+		{
+			SegmentStart += SegmentLengths[Segment];
+			Segment++;
+			BaseAlpha = 0.0f;
+			BaseDistance = 0.0f;
+		}
+
+		const float Target = ArcDistance - SegmentStart;
+		float Lower = BaseAlpha;
+		float Upper = 1.0f;
+		float Alpha = bWarmStart && BoneSegments[Index] == Segment ? BoneAlphas[Index] : Target / FMath::Max(SegmentLengths[Segment], UE_SMALL_NUMBER);
+		Alpha = FMath::Clamp(Alpha, Lower, Upper);
+
+		// Newton on the arc length within the segment, falls back to bisection where the tangent vanishes
+		for (int32 Step = 0; Step < Steps; Step++)
+		{
+			const float Error = BaseDistance + Integrate(Segment, BaseAlpha, Alpha) - Target;
+			if (Error < 0.0f)
+			{
+				Lower = Alpha;
+			}
+			else
+			{
+				Upper = Alpha;
+			}
+
+			const float Speed = Derivative(Segment, Alpha).Size();
+			const float Next = FMath::IsNearlyZero(Speed) ? Lower - 1.0f : Alpha - Error / Speed;
+			Alpha = Next > Lower && Next < Upper ? Next : (Lower + Upper) * 0.5f;
+		}
+
+		// Next bone integrates from here, targets are absolute so the residual doesn't accumulate
+		BoneSegments[Index] = Segment;
+		BoneAlphas[Index] = Alpha;
+		BaseAlpha = Alpha;
+		BaseDistance = Target;
+	}
+}
+
+FRigUnit_SplineIK_Execute()
+{
+	DECLARE_SCOPE_HIERARCHICAL_COUNTER_RIGUNIT();
+	ANGRY_RIGUNIT_TRACE_SCOPE(SplineIK);
+	ANGRY_RIGUNIT_TRACE_COUNT(ChainLength, Chain.Num());
+	URigHierarchy* Hierarchy = ExecuteContext.Hierarchy;
+	if (!Hierarchy)
+	{
+		return;
+	}
+
+	const int32 ChainCount = Chain.Num();
+	if (ChainCount < 2)
+	{
+		UE_CONTROLRIG_RIGUNIT_REPORT_WARNING(TEXT("Chain has to have length at least 2."));
+	}
+	else if (!ChainCache.Update(Chain, Hierarchy))
+	{
+		UE_CONTROLRIG_RIGUNIT_REPORT_WARNING(TEXT("Chain contains invalid elements."));
+	}
+	else if (FMath::IsNearlyZero(ChainCache.InitialChainLength))
+	{
+		UE_CONTROLRIG_RIGUNIT_REPORT_WARNING(TEXT("Total chain length is null."));
+	}
+	else
+	{
+		TArray<FCachedRigElement>& CachedChain = ChainCache.CachedChain;
+		const FTransform EndEETarget = GET_IK_OBJECTIVE_TRANSFORM();
+		const FTransform Origin = Hierarchy->GetGlobalTransform(CachedChain[0]);
+
+		// Spline keys are chain root, controls and objective
+		const int32 ControlNum = Controls.Num();
+		const int32 KeyNum = ControlNum + 2;
+
+		TArray<FVector>& Points = WorkData.Points;
+		TArray<float>& TwistAngles = WorkData.TwistAngles;
+		Points.SetNumUninitialized(KeyNum, false);
+		TwistAngles.SetNumUninitialized(KeyNum, false);
+
+		Points[0] = Origin.GetLocation();
+		for (int32 Index = 0; Index < ControlNum; Index++)
+		{
+			Points[Index + 1] = Controls[Index].GetLocation();
+		}
+		Points[KeyNum - 1] = EndEETarget.GetLocation();
+		WorkData.Update(ChainCache, PositionAlongSpline, ArcLengthIterations);
+
+		// Accumulate twist between consecutive keys around the segment direction,
+		// the root has no rotation of its own so twist starts at the first control
+		FQuat Previous = ControlNum > 0 ? Controls[0].GetRotation() : EndEETarget.GetRotation();
+		TwistAngles[0] = 0.0f;
+		for (int32 Index = 1; Index < KeyNum; Index++)
+		{
+			const FQuat Current = Index <= ControlNum ? Controls[Index - 1].GetRotation() : EndEETarget.GetRotation();
+			const FVector Axis = (Points[Index] - Points[Index - 1]).GetSafeNormal();
+
+			FQuat Swing, TwistRotation;
+			(Current * Previous.Inverse()).ToSwingTwist(Axis, Swing, TwistRotation);
+			TwistAngles[Index] = TwistAngles[Index - 1] + (Axis.IsZero() ? 0.0f : TwistRotation.GetTwistAngle(Axis));
+			Previous = Current;
+		}
+
+		// Only record debug primitives if enabled
+		FRigDebugBuffer* Debug = DebugSettings.IsEnabled() ? &ChainCache.DebugBuffer : nullptr;
+		if (Debug)
+		{
+			for (int32 Index = 1; Index < KeyNum; Index++)
+			{
+				Debug->AddLine(Points[Index - 1], Points[Index], DebugSettings.Scale * 0.2f, FLinearColor::Blue);
+			}
+		}
+
+		auto ApplyTwist = [&](FTransform& Transform, const FTransform& Local, int32 Index, float& AppliedTwist)
+		{
+			const int32 Segment = WorkData.BoneSegments[Index];
+			const float Angle = FMath::Lerp(TwistAngles[Segment], TwistAngles[Segment + 1], WorkData.BoneAlphas[Index]) * Twist;
+			const FVector Axis = Transform.TransformVectorNoScale(Local.GetLocation()).GetSafeNormal();
+			if (!Axis.IsZero())
+			{
+				// Children inherit the twist of their parent, only apply the difference
+				Transform.SetRotation(FQuat(Axis, Angle - AppliedTwist) * Transform.GetRotation());
+				AppliedTwist = Angle;
+			}
+		};
+
+		// Move chain along spline
+		TArray<FTransform>& Transforms = ChainCache.WriteBack.Transforms;
+		FTransform Transform = Origin;
+		float AppliedTwist = 0.0f;
+		for (int32 Index = 1; Index < ChainCount; Index++)
+		{
+			const FVector NextLocation = WorkData.Evaluate(WorkData.BoneSegments[Index], WorkData.BoneAlphas[Index]);
+
+			if (Debug)
+			{
+				Debug->AddPoint(NextLocation, DebugSettings.Scale * 2.0f, FLinearColor::Red);
+			}
+
+			// Twist around current bone direction before bending, which is the same as twisting around the bent direction after
+			const FTransform Local = ChainCache.WriteBack.GetLocalTransform(Hierarchy, Index);
+			ApplyTwist(Transform, Local, Index - 1, AppliedTwist);
+
+			FTransform Next;
+			Transforms[Index - 1] = FRigUnit_BendTowards::BendTransform(Transform, Local, NextLocation, ScaleType, 1.0f, Next);
+			Transform = Next;
+		}
+
+		// Set last member of chain, twist around the last segment
+		const FTransform LastLocal = ChainCache.WriteBack.GetLocalTransform(Hierarchy, ChainCount - 1);
+		ApplyTwist(Transform, LastLocal, ChainCount - 1, AppliedTwist);
+		Transform.SetRotation(FQuat::Slerp(EndEETarget.GetRotation(), Transform.GetRotation(), RotateWithTangent));
+		Transform.SetScale3D(Objective.GetScale3D());
+		Transforms.Last() = Transform;
+
+		ChainCache.WriteBack.Commit(Hierarchy, PropagateToChildren);
+
+		if (Debug)
+		{
+			Debug->Flush(ExecuteContext.GetDrawInterface());
+		}
+	}
+}
@@ -1,7 +1,6 @@
 
 
 #include "ControlRig/RigUnit_Analysis.h"
-#include "Structures/Matrix3x3.h"
 
 #include "ControlRig.h"
 #include "Units/RigUnitContext.h"
@@ -9,6 +8,7 @@
 FRigUnit_MeanDirection_Execute()
 {
 	DECLARE_SCOPE_HIERARCHICAL_COUNTER_RIGUNIT();
+	ANGRY_RIGUNIT_TRACE_SCOPE(MeanDirection);
 	const URigHierarchy* Hierarchy = ExecuteContext.Hierarchy;
 	if (!Hierarchy)
 	{
@@ -49,9 +49,80 @@ FRigUnit_MeanDirection_Execute()
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+void FRigUnit_PowerDirection::ComputeSymmetricEigen(const double (&Matrix)[3][3], FVector& EigenValues, FVector (&Axes)[3])
+{
+	double A[3][3];
+	double V[3][3] = { { 1.0, 0.0, 0.0 }, { 0.0, 1.0, 0.0 }, { 0.0, 0.0, 1.0 } };
+	FMemory::Memcpy(A, Matrix, sizeof(A));
+
+	// Cyclic Jacobi, converges quadratically so a handful of sweeps reach double precision
+	constexpr int32 MaxSweeps = 12;
+	const double Scale = FMath::Abs(A[0][0]) + FMath::Abs(A[1][1]) + FMath::Abs(A[2][2]);
+	for (int32 Sweep = 0; Sweep < MaxSweeps; Sweep++)
+	{
+		const double OffDiagonal = FMath::Abs(A[0][1]) + FMath::Abs(A[0][2]) + FMath::Abs(A[1][2]);
+		if (OffDiagonal <= Scale * 1.0e-15 || OffDiagonal < UE_DOUBLE_SMALL_NUMBER)
+		{
+			break;
+		}
+
+		for (int32 P = 0; P < 2; P++)
+		{
+			for (int32 Q = P + 1; Q < 3; Q++)
+			{
+				const double Apq = A[P][Q];
+				if (FMath::Abs(Apq) < UE_DOUBLE_SMALL_NUMBER)
+				{
+					continue;
+				}
+
+				// Rotation that zeroes the off-diagonal entry
+				const double Theta = (A[Q][Q] - A[P][P]) / (2.0 * Apq);
+				const double T = (Theta >= 0.0 ? 1.0 : -1.0) / (FMath::Abs(Theta) + FMath::Sqrt(Theta * Theta + 1.0));
+				const double C = 1.0 / FMath::Sqrt(T * T + 1.0);
+				const double S = T * C;
+
+				A[P][P] -= T * Apq;
+				A[Q][Q] += T * Apq;
+				A[P][Q] = A[Q][P] = 0.0;
+
+				const int32 R = 3 - P - Q;
+				const double Arp = A[R][P];
+				const double Arq = A[R][Q];
+				A[R][P] = A[P][R] = C * Arp - S * Arq;
+				A[R][Q] = A[Q][R] = S * Arp + C * Arq;
+
+				for (int32 K = 0; K < 3; K++)
+				{
+					const double Vkp = V[K][P];
+					const double Vkq = V[K][Q];
+					V[K][P] = C * Vkp - S * Vkq;
+					V[K][Q] = S * Vkp + C * Vkq;
+				}
+			}
+		}
+	}
+
+	// Sort by descending eigenvalue
+	int32 Order[3] = { 0, 1, 2 };
+	if (A[Order[0]][Order[0]] < A[Order[1]][Order[1]]) Swap(Order[0], Order[1]);
+	if (A[Order[1]][Order[1]] < A[Order[2]][Order[2]]) Swap(Order[1], Order[2]);
+	if (A[Order[0]][Order[0]] < A[Order[1]][Order[1]]) Swap(Order[0], Order[1]);
+
+	for (int32 Index = 0; Index < 2; Index++)
+	{
+		const int32 Column = Order[Index];
+		EigenValues[Index] = A[Column][Column];
+		Axes[Index] = FVector(V[0][Column], V[1][Column], V[2][Column]).GetSafeNormal();
+	}
+	EigenValues[2] = A[Order[2]][Order[2]];
+	Axes[2] = FVector::CrossProduct(Axes[0], Axes[1]);
+}
+
 FRigUnit_PowerDirection_Execute()
 {
 	DECLARE_SCOPE_HIERARCHICAL_COUNTER_RIGUNIT();
+	ANGRY_RIGUNIT_TRACE_SCOPE(PowerDirection);
 	const URigHierarchy* Hierarchy = ExecuteContext.Hierarchy;
 	if (!Hierarchy)
 	{
@@ -59,28 +130,65 @@ FRigUnit_PowerDirection_Execute()
 	}
 
 	Output = FVector::ForwardVector;
+	Frame = FTransform::Identity;
+	EigenValues = FVector::ZeroVector;
 
-	TArray<FVector> Samples;
 	const int32 Num = Chain.Num();
-	Samples.Reserve(Num);
 	if (Num >= 2)
 	{
-		FVector Mean = FVector::ZeroVector;
-		for (int32 Index = 0; Index < Num; Index++)
+		// Accumulate covariance in one pass, samples are relative to the first for precision
+		const FVector First = Hierarchy->GetGlobalTransform(Chain[0]).GetLocation();
+		FVector Last = First;
+		FVector Sum = FVector::ZeroVector;
+		double Moments[3][3] = {};
+		for (int32 Index = 1; Index < Num; Index++)
 		{
-			const FVector Sample = Hierarchy->GetGlobalTransform(Chain[Index]).GetLocation();
-			Samples.Emplace(Sample);
-			Mean += Sample;
+			Last = Hierarchy->GetGlobalTransform(Chain[Index]).GetLocation();
+			const FVector Sample = Last - First;
+			Sum += Sample;
+			for (int32 Row = 0; Row < 3; Row++)
+			{
+				for (int32 Col = Row; Col < 3; Col++)
+				{
+					Moments[Row][Col] += Sample[Row] * Sample[Col];
+				}
+			}
 		}
-		Mean /= Num;
 
-		for (FVector& Sample : Samples)
+		const FVector Mean = Sum / Num;
+		const FVector Chord = (Last - First).GetSafeNormal();
+
+		const int32 LOD = LODSettings.GetLOD(ExecuteContext);
+		if (LODSettings.GetQuality(LOD) == ESolverQuality::Approximate)
 		{
-			Sample -= Mean;
+			// Chord of the chain approximates its principal direction
+			Output = Chord;
+			Frame = FTransform(FRotationMatrix::MakeFromX(Output).ToQuat(), First + Mean);
 		}
+		else
+		{
+			double Covariance[3][3];
+			for (int32 Row = 0; Row < 3; Row++)
+			{
+				for (int32 Col = Row; Col < 3; Col++)
+				{
+					Covariance[Row][Col] = Covariance[Col][Row] = Moments[Row][Col] / Num - Mean[Row] * Mean[Col];
+				}
+			}
 
-		Output = (Samples[1] - Samples[0]).GetSafeNormal();
-		Output = FMatrix3x3(Samples).PowerMethod(Output, Iterations);
+			FVector Axes[3];
+			ComputeSymmetricEigen(Covariance, EigenValues, Axes);
+
+			// Main direction points along the chain, flip the third axis along to stay right handed
+			if ((Axes[0] | Chord) < 0.0f)
+			{
+				Axes[0] = -Axes[0];
+				Axes[2] = -Axes[2];
+			}
+
+			Output = Axes[0];
+			Frame = FTransform(Axes[0], Axes[1], Axes[2], First + Mean);
+		}
 	}
 }
 
@@ -120,6 +228,7 @@ void FRigUnit_ChainAnalysis::Analysis(const FRigElementKeyCollection& Chain, con
 FRigUnit_ChainAnalysis_Execute()
 {
 	DECLARE_SCOPE_HIERARCHICAL_COUNTER_RIGUNIT();
+	ANGRY_RIGUNIT_TRACE_SCOPE(ChainAnalysis);
 	const URigHierarchy* Hierarchy = ExecuteContext.Hierarchy;
 	if (!Hierarchy)
 	{
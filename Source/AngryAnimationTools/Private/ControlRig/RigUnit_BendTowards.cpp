@@ -6,8 +6,12 @@
 
 FTransform FRigUnit_BendTowards::BendTowards(const FRigElementKey& Current, const FRigElementKey& Next, const FVector& Target, URigHierarchy* Hierarchy, EBendScaleType type, bool bPropagateToChildren, float Intensity)
 {
-	FTransform Transform = Hierarchy->GetGlobalTransform(Current);
-	const FTransform Local = Hierarchy->GetLocalTransform(Next);
+	return BendTowards(FCachedRigElement(Current, Hierarchy), FCachedRigElement(Next, Hierarchy), Target, Hierarchy, type, bPropagateToChildren, Intensity);
+}
+
+FTransform FRigUnit_BendTowards::BendTransform(const FTransform& Current, const FTransform& Local, const FVector& Target, EBendScaleType type, float Intensity, FTransform& Next)
+{
+	FTransform Transform = Current;
 
 	// Rotate to match
 	const FVector CurrentLocation = Transform.GetLocation();
@@ -20,28 +24,14 @@ FTransform FRigUnit_BendTowards::BendTowards(const FRigElementKey& Current, cons
 	{
 		case EBendScaleType::Default:
 		{
-			//FTransform NextTransform = Hierarchy->GetGlobalTransform(Next);
-
-			// Rotate current element (We need to propagate here in case other children are attached to current)
-			Hierarchy->SetGlobalTransform(Current, Transform, false, bPropagateToChildren);
-
 			// Move next element towards desired target without changing scale 
-			// (TODO: if bPropagateToChildren true we do some of these computations double)
-			FTransform NextTransform = Local * Transform;
-			NextTransform.SetLocation(CurrentLocation + TargetDelta);
-			Hierarchy->SetGlobalTransform(Next, NextTransform, false, bPropagateToChildren);
+			Next = Local * Transform;
+			Next.SetLocation(CurrentLocation + TargetDelta);
 			break;
 		}
 		case EBendScaleType::None:
 		{
-			// Rotate current element
-			Hierarchy->SetGlobalTransform(Current, Transform, false, bPropagateToChildren);
-
-			// Result is identical if propagate is on
-			if (!bPropagateToChildren)
-			{
-				Hierarchy->SetGlobalTransform(Next, Local * Transform, false, false);
-			}
+			Next = Local * Transform;
 			break;
 		}
 		case EBendScaleType::Stretch:
@@ -54,23 +44,37 @@ FTransform FRigUnit_BendTowards::BendTowards(const FRigElementKey& Current, cons
 				Transform.SetScale3D(Transform.GetScale3D() * (FVector::OneVector + AxisScale * Local.GetLocation().GetSafeNormal().GetAbs()));
 			}
 
-			// Update chain element
-			Hierarchy->SetGlobalTransform(Current, Transform, false, bPropagateToChildren);
-
-			// Propagate to only next in line if propagation is turned off
-			if (!bPropagateToChildren)
-			{
-				Hierarchy->SetGlobalTransform(Next, Local * Transform, false, false);
-			}
+			Next = Local * Transform;
 			break;
 		}
 	}
 	return Transform;
 }
 
+FTransform FRigUnit_BendTowards::BendTowards(const FCachedRigElement& CurrentCache, const FCachedRigElement& NextCache, const FVector& Target, URigHierarchy* Hierarchy, EBendScaleType type, bool bPropagateToChildren, float Intensity)
+{
+	const int32 Current = CurrentCache.GetIndex();
+	const int32 Next = NextCache.GetIndex();
+
+	FTransform NextTransform;
+	const FTransform Transform = BendTransform(Hierarchy->GetGlobalTransform(Current), Hierarchy->GetLocalTransform(Next), Target, type, Intensity, NextTransform);
+
+	// Rotate current element (We need to propagate here in case other children are attached to current)
+	FRigTracedWrite::SetGlobalTransform(Hierarchy, Current, Transform, false, bPropagateToChildren);
+
+	// Result is identical if propagate is on unless next element was moved independently
+	// (Chain solvers should use FRigChainWriteBack instead to not propagate for every segment)
+	if (type == EBendScaleType::Default || !bPropagateToChildren)
+	{
+		FRigTracedWrite::SetGlobalTransform(Hierarchy, Next, NextTransform, false, bPropagateToChildren);
+	}
+	return Transform;
+}
+
 FRigUnit_BendTowards_Execute()
 {
 	DECLARE_SCOPE_HIERARCHICAL_COUNTER_RIGUNIT();
+	ANGRY_RIGUNIT_TRACE_SCOPE(BendTowards);
 	URigHierarchy* Hierarchy = ExecuteContext.Hierarchy;
 	if (!Hierarchy)
 	{
@@ -13,6 +13,7 @@ float FRigUnit_SoftLimitValue::SoftLimit(float Value, float Limit)
 FRigUnit_SoftLimitValue_Execute()
 {
 	DECLARE_SCOPE_HIERARCHICAL_COUNTER_RIGUNIT();
+	ANGRY_RIGUNIT_TRACE_SCOPE(SoftLimitValue);
 	const URigHierarchy* Hierarchy = ExecuteContext.Hierarchy;
 
 	if (!Hierarchy)
@@ -59,6 +60,7 @@ FQuat FRigUnit_LimitRotation::LimitRotation(const FQuat& Quat, float Limit, bool
 FRigUnit_LimitRotation_Execute()
 {
 	DECLARE_SCOPE_HIERARCHICAL_COUNTER_RIGUNIT();
+	ANGRY_RIGUNIT_TRACE_SCOPE(LimitRotation);
 	const URigHierarchy* Hierarchy = ExecuteContext.Hierarchy;
 
 	if (!Hierarchy)
@@ -87,6 +89,7 @@ FQuat FRigUnit_LimitRotationAroundAxis::AxisLimitRotation(const FQuat& Quat, con
 FRigUnit_LimitRotationAroundAxis_Execute()
 {
 	DECLARE_SCOPE_HIERARCHICAL_COUNTER_RIGUNIT();
+	ANGRY_RIGUNIT_TRACE_SCOPE(LimitRotationAroundAxis);
 	const URigHierarchy* Hierarchy = ExecuteContext.Hierarchy;
 
 	if (!Hierarchy)
@@ -102,6 +105,7 @@ FRigUnit_LimitRotationAroundAxis_Execute()
 FRigUnit_BellCurve_Execute()
 {
 	DECLARE_SCOPE_HIERARCHICAL_COUNTER_RIGUNIT();
+	ANGRY_RIGUNIT_TRACE_SCOPE(BellCurve);
 	const URigHierarchy* Hierarchy = ExecuteContext.Hierarchy;
 
 	if (!Hierarchy)
@@ -117,6 +121,7 @@ FRigUnit_BellCurve_Execute()
 FRigUnit_DistanceBellCurve_Execute()
 {
 	DECLARE_SCOPE_HIERARCHICAL_COUNTER_RIGUNIT();
+	ANGRY_RIGUNIT_TRACE_SCOPE(DistanceBellCurve);
 	const URigHierarchy* Hierarchy = ExecuteContext.Hierarchy;
 
 	if (!Hierarchy)
@@ -133,6 +138,7 @@ FRigUnit_DistanceBellCurve_Execute()
 FRigUnit_Atan2_Execute()
 {
 	DECLARE_SCOPE_HIERARCHICAL_COUNTER_RIGUNIT();
+	ANGRY_RIGUNIT_TRACE_SCOPE(Atan2);
 	const URigHierarchy* Hierarchy = ExecuteContext.Hierarchy;
 
 	if (!Hierarchy)
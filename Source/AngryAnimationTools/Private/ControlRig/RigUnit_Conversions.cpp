@@ -8,6 +8,7 @@
 FRigUnit_SetTransformWithOffset_Execute()
 {
 	DECLARE_SCOPE_HIERARCHICAL_COUNTER_RIGUNIT();
+	ANGRY_RIGUNIT_TRACE_SCOPE(SetTransformWithOffset);
 	URigHierarchy* Hierarchy = ExecuteContext.Hierarchy;
 
 	if (!Hierarchy)
@@ -22,7 +23,7 @@ FRigUnit_SetTransformWithOffset_Execute()
 	else
 	{
 		const FTransform Output = FTransform(OffsetRotation, OffsetTranslation) * Transform;
-		Hierarchy->SetGlobalTransform(Cache, Output, bPropagateToChildren);
+		FRigTracedWrite::SetGlobalTransform(Hierarchy, Cache, Output, bPropagateToChildren, true);
 	}
 }
 
@@ -31,6 +32,7 @@ FRigUnit_SetTransformWithOffset_Execute()
 FRigUnit_CloneTransforms_Execute()
 {
 	DECLARE_SCOPE_HIERARCHICAL_COUNTER_RIGUNIT();
+	ANGRY_RIGUNIT_TRACE_SCOPE(CloneTransforms);
 	URigHierarchy* Hierarchy = ExecuteContext.Hierarchy;
 
 	if (!Hierarchy)
@@ -45,7 +47,7 @@ FRigUnit_CloneTransforms_Execute()
 		const FRigElementKey NewKey = FRigElementKey(Items[Index].Name, TargetType);
 		if (Hierarchy->GetIndex(NewKey) != INDEX_NONE)
 		{
-			Hierarchy->SetGlobalTransform(NewKey, Transform, false, false);
+			FRigTracedWrite::SetGlobalTransform(Hierarchy, NewKey, Transform, false, false);
 		}
 	}
 }
@@ -55,6 +57,7 @@ FRigUnit_CloneTransforms_Execute()
 FRigUnit_Rebase_Execute()
 {
 	DECLARE_SCOPE_HIERARCHICAL_COUNTER_RIGUNIT();
+	ANGRY_RIGUNIT_TRACE_SCOPE(Rebase);
 	
 	Output = (Transform * FromSpace.Inverse());
 	Output.SetLocation(Output.GetLocation() * TranslationScale);
@@ -66,6 +69,7 @@ FRigUnit_Rebase_Execute()
 FRigUnit_AffineRebase_Execute()
 {
 	DECLARE_SCOPE_HIERARCHICAL_COUNTER_RIGUNIT();
+	ANGRY_RIGUNIT_TRACE_SCOPE(AffineRebase);
 
 	Output.SetLocation((Transform.GetLocation() - FromSpace.GetLocation()) * TranslationScale + ToSpace.GetLocation());
 	Output.SetRotation((Transform.GetRotation() * FromSpace.GetRotation().Inverse()) * ToSpace.GetRotation());
@@ -98,6 +102,7 @@ FQuat FRigUnit_AxisAlignRotation::ComputeHeadingRotation(const FVector& SourceFo
 FRigUnit_AxisAlignRotation_Execute()
 {
 	DECLARE_SCOPE_HIERARCHICAL_COUNTER_RIGUNIT();
+	ANGRY_RIGUNIT_TRACE_SCOPE(AxisAlignRotation);
 
 	if (SourceForward.IsNearlyZero())
 	{
@@ -126,6 +131,7 @@ FRigUnit_AxisAlignRotation_Execute()
 FRigUnit_RotationBetween_Execute()
 {
 	DECLARE_SCOPE_HIERARCHICAL_COUNTER_RIGUNIT();
+	ANGRY_RIGUNIT_TRACE_SCOPE(RotationBetween);
 	const URigHierarchy* Hierarchy = ExecuteContext.Hierarchy;
 
 	if (!Hierarchy)
@@ -141,6 +147,7 @@ FRigUnit_RotationBetween_Execute()
 FRigUnit_ProjectOntoPlane_Execute()
 {
 	DECLARE_SCOPE_HIERARCHICAL_COUNTER_RIGUNIT();
+	ANGRY_RIGUNIT_TRACE_SCOPE(ProjectOntoPlane);
 	const URigHierarchy* Hierarchy = ExecuteContext.Hierarchy;
 
 	if (!Hierarchy)
@@ -165,6 +172,7 @@ FRigUnit_ProjectOntoPlane_Execute()
 FRigUnit_WarpAlongDirection_Execute()
 {
 	DECLARE_SCOPE_HIERARCHICAL_COUNTER_RIGUNIT();
+	ANGRY_RIGUNIT_TRACE_SCOPE(WarpAlongDirection);
 	const URigHierarchy* Hierarchy = ExecuteContext.Hierarchy;
 
 	if (!Hierarchy)
@@ -184,6 +192,7 @@ FRigUnit_WarpAlongDirection_Execute()
 FRigUnit_ScaleToValue_Execute()
 {
 	DECLARE_SCOPE_HIERARCHICAL_COUNTER_RIGUNIT();
+	ANGRY_RIGUNIT_TRACE_SCOPE(ScaleToValue);
 	const URigHierarchy* Hierarchy = ExecuteContext.Hierarchy;
 
 	if (!Hierarchy)
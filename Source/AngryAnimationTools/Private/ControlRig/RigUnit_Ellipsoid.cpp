@@ -6,24 +6,94 @@
 #include "ControlRig/RigUnit_BendTowards.h"
 #include "Units/RigUnitContext.h"
 
+// Near zero scale axes would make the inverse transform degenerate
+static FTransform ClampEllipsoidScale(const FTransform& Transform)
+{
+	FTransform NormalizedTransform = Transform;
+	FVector Scale = NormalizedTransform.GetScale3D();
+	if (FMath::IsNearlyZero(Scale.X)) Scale.X = 0.01f;
+	if (FMath::IsNearlyZero(Scale.Y)) Scale.Y = 0.01f;
+	if (FMath::IsNearlyZero(Scale.Z)) Scale.Z = 0.01f;
+	NormalizedTransform.SetScale3D(Scale);
+	return NormalizedTransform;
+}
+
+FEllipsoidSpace::FEllipsoidSpace(const FTransform& Transform)
+	: ToLocal(Transform.ToInverseMatrixWithScale())
+	, ToWorld(Transform.ToMatrixWithScale())
+	, Scale(Transform.GetScale3D())
+	, InvScale(FTransform::GetSafeScaleReciprocal(Transform.GetScale3D()))
+{
+}
+
+// Space and radius of a single ellipsoid input, taken from the collider set if an index is given, scale is clamped either way
+static bool ResolveEllipsoid(const URigHierarchy* Hierarchy, const FEllipsoid& Ellipsoid, FCachedRigElement& Cache, const FEllipsoidColliderSet& ColliderSet, int32 ColliderIndex, FEllipsoidSpace& Space, float& Radius)
+{
+	if (ColliderIndex != INDEX_NONE)
+	{
+		if (!ColliderSet.IsValidIndex(ColliderIndex))
+		{
+			return false;
+		}
+
+		Space = ColliderSet.Spaces[ColliderIndex];
+		Radius = ColliderSet.Radii[ColliderIndex];
+		return true;
+	}
+
+	if (!Cache.UpdateCache(Ellipsoid.Key, Hierarchy))
+	{
+		return false;
+	}
+
+	Space = FEllipsoidSpace(ClampEllipsoidScale(Hierarchy->GetGlobalTransform(Cache)));
+	Radius = Ellipsoid.Radius;
+	return true;
+}
+
+static FString DescribeEllipsoid(const FEllipsoid& Ellipsoid, int32 ColliderIndex)
+{
+	return ColliderIndex != INDEX_NONE ? FString::Printf(TEXT("collider %d"), ColliderIndex) : FString::Printf(TEXT("key '%s'"), *Ellipsoid.Key.ToString());
+}
+
 void FRigUnit_EllipsoidProjection::ComputeEllispoidProjection(const FTransform& Transform, float Radius, const FVector& Point, FVector& Closest, FVector& Normal)
 {
-	const FVector Scale = Transform.GetScale3D();
+	ComputeEllispoidProjection(FEllipsoidSpace(Transform), Radius, Point, Closest, Normal);
+}
+
+void FRigUnit_EllipsoidProjection::ComputeEllispoidProjectionNewton(const FTransform& Transform, float Radius, const FVector& Point, int32 Iterations, FVector& Closest, FVector& Normal)
+{
+	ComputeEllispoidProjectionNewton(FEllipsoidSpace(Transform), Radius, Point, Iterations, Closest, Normal);
+}
+
+void FRigUnit_EllipsoidProjection::ComputeEllispoidProjectionApproximate(const FTransform& Transform, float Radius, const FVector& Point, FVector& Closest, FVector& Normal)
+{
+	ComputeEllispoidProjectionApproximate(FEllipsoidSpace(Transform), Radius, Point, Closest, Normal);
+}
+
+void FRigUnit_EllipsoidProjection::ComputeEllispoidProjection(EEllipsoidProjectionMode Mode, int32 Iterations, const FTransform& Transform, float Radius, const FVector& Point, FVector& Closest, FVector& Normal)
+{
+	ComputeEllispoidProjection(Mode, Iterations, FEllipsoidSpace(Transform), Radius, Point, Closest, Normal);
+}
+
+void FRigUnit_EllipsoidProjection::ComputeEllispoidProjection(const FEllipsoidSpace& Space, float Radius, const FVector& Point, FVector& Closest, FVector& Normal)
+{
+	const FVector& Scale = Space.Scale;
 	if (FMath::IsNearlyZero(Scale.X * Scale.Y * Scale.Z))
 	{
-		Closest = Transform.GetLocation();
+		Closest = Space.GetLocation();
 		Normal = (Point - Closest).GetSafeNormal();
 		return;
 	}
 
 	// Warp the input along scale to get an appropriate ray direction that will alyways intersect the ellipsoid again
-	const FVector ScaledNormal = (Transform.InverseTransformPosition(Point) * Scale).GetSafeNormal();
-	const FVector ProjectedNormal = Transform.TransformVectorNoScale((ScaledNormal / Scale)).GetSafeNormal();
+	const FVector ScaledNormal = (Space.InverseTransformPosition(Point) * Scale).GetSafeNormal();
+	const FVector ProjectedNormal = Space.TransformNormal(ScaledNormal).GetSafeNormal();
 	const float RayDistance = Scale.GetAbsMax() * Radius;
 
 	// Reproject for ellipsoid intersection
-	const FVector RayStart = Transform.InverseTransformPosition(Point + ProjectedNormal * RayDistance);
-	const FVector RayEnd = Transform.InverseTransformPosition(Point - ProjectedNormal * RayDistance);
+	const FVector RayStart = Space.InverseTransformPosition(Point + ProjectedNormal * RayDistance);
+	const FVector RayEnd = Space.InverseTransformPosition(Point - ProjectedNormal * RayDistance);
 	const FVector RayDelta = RayEnd - RayStart;
 	const float RayLength = RayDelta.Size();
 	const FVector RayDir = RayDelta / RayLength;
@@ -42,31 +112,115 @@ void FRigUnit_EllipsoidProjection::ComputeEllispoidProjection(const FTransform&
 	const FVector IntersectionNormal = (RayStart + RayDir * FMath::Clamp(Value, 0.0f, RayLength)).GetSafeNormal();
 
 	// Transform back to world
-	Normal = Transform.TransformVectorNoScale((IntersectionNormal / Scale)).GetSafeNormal();
-	Closest = Transform.TransformPosition(IntersectionNormal * Radius);
+	Normal = Space.TransformNormal(IntersectionNormal).GetSafeNormal();
+	Closest = Space.TransformPosition(IntersectionNormal * Radius);
+}
+
+void FRigUnit_EllipsoidProjection::ComputeEllispoidProjectionNewton(const FEllipsoidSpace& Space, float Radius, const FVector& Point, int32 Iterations, FVector& Closest, FVector& Normal)
+{
+	const FVector Axes = Space.Scale.GetAbs() * Radius;
+	if (FMath::IsNearlyZero(Axes.X * Axes.Y * Axes.Z))
+	{
+		Closest = Space.GetLocation();
+		Normal = (Point - Closest).GetSafeNormal();
+		return;
+	}
+
+	// Closest point is e^2 y / (t + e^2) where t is the root of F(t) = |e y / (t + e^2)|^2 - 1
+	const FVector Local = Space.InverseTransformPositionNoScale(Point);
+	const FVector Axes2 = Axes * Axes;
+	const FVector Weighted = Axes * Local;
+
+	// Start left of the root where F is non-negative, F is convex and decreasing so Newton converges monotonically
+	const double MinParam = -Axes2.GetMin() * (1.0 - UE_KINDA_SMALL_NUMBER);
+	const FVector Bounds = Weighted.GetAbs() - Axes2;
+	double Param = FMath::Max(Bounds.GetMax(), MinParam);
+
+	for (int32 Iteration = 0; Iteration < Iterations; Iteration++)
+	{
+		const FVector Denominator = Axes2 + FVector(Param);
+		const FVector Ratio = Weighted / Denominator;
+		const FVector Ratio2 = Ratio * Ratio;
+		const double Value = Ratio2.X + Ratio2.Y + Ratio2.Z - 1.0;
+		const FVector Slope = Ratio2 / Denominator;
+		const double Derivative = -2.0 * (Slope.X + Slope.Y + Slope.Z);
+		if (FMath::IsNearlyZero(Value) || Derivative > -UE_SMALL_NUMBER)
+		{
+			break;
+		}
+
+		Param = FMath::Max(Param - Value / Derivative, MinParam);
+	}
+
+	const FVector Denominator = Axes2 + FVector(Param);
+	const FVector LocalNormal = Local / Denominator;
+
+	// Transform back to world
+	Normal = Space.TransformVectorNoScale(LocalNormal).GetSafeNormal();
+	Closest = Space.TransformPositionNoScale(Axes2 * LocalNormal);
+}
+
+void FRigUnit_EllipsoidProjection::ComputeEllispoidProjectionApproximate(const FEllipsoidSpace& Space, float Radius, const FVector& Point, FVector& Closest, FVector& Normal)
+{
+	const FVector Axes = Space.Scale.GetAbs() * Radius;
+	const FVector Local = Space.InverseTransformPositionNoScale(Point);
+	const FVector Gradient = Local / (Axes * Axes);
+	const float GradientLength = Gradient.Size();
+	if (FMath::IsNearlyZero(Axes.X * Axes.Y * Axes.Z) || FMath::IsNearlyZero(GradientLength))
+	{
+		Closest = Space.GetLocation();
+		Normal = (Point - Closest).GetSafeNormal();
+		return;
+	}
+
+	// First order distance estimate of the implicit surface |y / e| = 1
+	const float Scaled = (Local / Axes).Size();
+	const float Distance = Scaled * (Scaled - 1.0f) / GradientLength;
+	const FVector LocalNormal = Gradient / GradientLength;
+
+	Normal = Space.TransformVectorNoScale(LocalNormal);
+	Closest = Space.TransformPositionNoScale(Local - LocalNormal * Distance);
+}
+
+void FRigUnit_EllipsoidProjection::ComputeEllispoidProjection(EEllipsoidProjectionMode Mode, int32 Iterations, const FEllipsoidSpace& Space, float Radius, const FVector& Point, FVector& Closest, FVector& Normal)
+{
+	switch (Mode)
+	{
+	case EEllipsoidProjectionMode::Newton:
+		ComputeEllispoidProjectionNewton(Space, Radius, Point, Iterations, Closest, Normal);
+		break;
+	case EEllipsoidProjectionMode::Approximate:
+		ComputeEllispoidProjectionApproximate(Space, Radius, Point, Closest, Normal);
+		break;
+	default:
+		ComputeEllispoidProjection(Space, Radius, Point, Closest, Normal);
+		break;
+	}
 }
 
 FRigUnit_EllipsoidProjection_Execute()
 {
 	DECLARE_SCOPE_HIERARCHICAL_COUNTER_RIGUNIT();
+	ANGRY_RIGUNIT_TRACE_SCOPE(EllipsoidProjection);
 	const URigHierarchy* Hierarchy = ExecuteContext.Hierarchy;
-	FRigVMDrawInterface* DrawInterface = ExecuteContext.GetDrawInterface();
+	FRigVMDrawInterface* DrawInterface = DebugSettings.IsEnabled() ? ExecuteContext.GetDrawInterface() : nullptr;
 
 	if (!Hierarchy)
 	{
 		return;
 	}
 
-	if (!EllipsoidCache.UpdateCache(Ellipsoid.Key, Hierarchy))
+	FEllipsoidSpace Space;
+	float Radius;
+	if (!ResolveEllipsoid(Hierarchy, Ellipsoid, EllipsoidCache, ColliderSet, ColliderIndex, Space, Radius))
 	{
-		UE_CONTROLRIG_RIGUNIT_REPORT_WARNING(TEXT("key '%s' is not valid."), *Ellipsoid.Key.ToString());
+		UE_CONTROLRIG_RIGUNIT_REPORT_WARNING(TEXT("%s is not valid."), *DescribeEllipsoid(Ellipsoid, ColliderIndex));
 	}
 	else
 	{
-		const FTransform Transform = Hierarchy->GetGlobalTransform(EllipsoidCache);
-		ComputeEllispoidProjection(Transform, Ellipsoid.Radius, Point, Closest, Normal);
+		ComputeEllispoidProjection(ProjectionMode, Iterations, Space, Radius, Point, Closest, Normal);
 
-		if (DebugSettings.bEnabled)
+		if (DebugSettings.IsEnabled())
 		{
 			DrawInterface->DrawLine(FTransform::Identity, Closest, Closest + Normal * 25.0f, FLinearColor::Red, DebugSettings.Scale * 0.1f);
 		}
@@ -77,42 +231,49 @@ FRigUnit_EllipsoidProjection_Execute()
 
 float FRigUnit_EllipsoidPointPlaneProject::ComputeEllispoidPointPlaneProject(const FTransform& Transform, float Radius, const FVector& Point, const FVector& Normal, FVector& Projected)
 {
-	const FVector Scale = Transform.GetScale3D();
+	return ComputeEllispoidPointPlaneProject(FEllipsoidSpace(Transform), Radius, Point, Normal, Projected);
+}
+
+float FRigUnit_EllipsoidPointPlaneProject::ComputeEllispoidPointPlaneProject(const FEllipsoidSpace& Space, float Radius, const FVector& Point, const FVector& Normal, FVector& Projected)
+{
+	const FVector& Scale = Space.Scale;
 	if (FMath::IsNearlyZero(Scale.X * Scale.Y * Scale.Z))
 	{
-		Projected = Transform.GetLocation();
+		Projected = Space.GetLocation();
 		return 1.0f;
 	}
 
-	const FVector ScaledNormal = Transform.InverseTransformVector(Normal).GetSafeNormal();
-	const FVector ScaledPoint = Transform.InverseTransformPosition(Point);
+	const FVector ScaledNormal = Space.InverseTransformVector(Normal).GetSafeNormal();
+	const FVector ScaledPoint = Space.InverseTransformPosition(Point);
 
 	const float dot = ScaledNormal | ScaledPoint;
-	Projected = Transform.TransformPosition(ScaledPoint - dot * ScaledNormal);
+	Projected = Space.TransformPosition(ScaledPoint - dot * ScaledNormal);
 	return dot;
 }
 
 FRigUnit_EllipsoidPointPlaneProject_Execute()
 {
 	DECLARE_SCOPE_HIERARCHICAL_COUNTER_RIGUNIT();
+	ANGRY_RIGUNIT_TRACE_SCOPE(EllipsoidPointPlaneProject);
 	const URigHierarchy* Hierarchy = ExecuteContext.Hierarchy;
-	FRigVMDrawInterface* DrawInterface = ExecuteContext.GetDrawInterface();
+	FRigVMDrawInterface* DrawInterface = DebugSettings.IsEnabled() ? ExecuteContext.GetDrawInterface() : nullptr;
 
 	if (!Hierarchy)
 	{
 		return;
 	}
 
-	if (!EllipsoidCache.UpdateCache(Ellipsoid.Key, Hierarchy))
+	FEllipsoidSpace Space;
+	float Radius;
+	if (!ResolveEllipsoid(Hierarchy, Ellipsoid, EllipsoidCache, ColliderSet, ColliderIndex, Space, Radius))
 	{
-		UE_CONTROLRIG_RIGUNIT_REPORT_WARNING(TEXT("key '%s' is not valid."), *Ellipsoid.Key.ToString());
+		UE_CONTROLRIG_RIGUNIT_REPORT_WARNING(TEXT("%s is not valid."), *DescribeEllipsoid(Ellipsoid, ColliderIndex));
 	}
 	else
 	{
-		const FTransform Transform = Hierarchy->GetGlobalTransform(EllipsoidCache);
-		Distance = ComputeEllispoidPointPlaneProject(Transform, Ellipsoid.Radius, Point, Normal, Projected);
+		Distance = ComputeEllispoidPointPlaneProject(Space, Radius, Point, Normal, Projected);
 
-		if (DebugSettings.bEnabled)
+		if (DebugSettings.IsEnabled())
 		{
 			DrawInterface->DrawLine(FTransform::Identity, Projected, Point, FLinearColor::Red, DebugSettings.Scale * 0.1f);
 		}
@@ -123,15 +284,13 @@ FRigUnit_EllipsoidPointPlaneProject_Execute()
 
 float FRigUnit_EllipsoidRaycast::ComputeEllispoidRaycast(const FTransform& Transform, float Radius, const FVector& Start, const FVector& End, FVector& Impact, FVector& Normal, float& Distance)
 {
-	FTransform NormalizedTransform = Transform;
-	FVector Scale = NormalizedTransform.GetScale3D();
-	if (FMath::IsNearlyZero(Scale.X)) Scale.X = 0.01f;
-	if (FMath::IsNearlyZero(Scale.Y)) Scale.Y = 0.01f;
-	if (FMath::IsNearlyZero(Scale.Z)) Scale.Z = 0.01f;
-	NormalizedTransform.SetScale3D(Scale);
+	return ComputeEllispoidRaycast(FEllipsoidSpace(ClampEllipsoidScale(Transform)), Radius, Start, End, Impact, Normal, Distance);
+}
 
-	const FVector RayStart = NormalizedTransform.InverseTransformPosition(Start);
-	const FVector RayEnd = NormalizedTransform.InverseTransformPosition(End);
+float FRigUnit_EllipsoidRaycast::ComputeEllispoidRaycast(const FEllipsoidSpace& Space, float Radius, const FVector& Start, const FVector& End, FVector& Impact, FVector& Normal, float& Distance)
+{
+	const FVector RayStart = Space.InverseTransformPosition(Start);
+	const FVector RayEnd = Space.InverseTransformPosition(End);
 	const FVector RayDelta = RayEnd - RayStart;
 	const float RayLength = RayDelta.Size();
 
@@ -139,7 +298,7 @@ float FRigUnit_EllipsoidRaycast::ComputeEllispoidRaycast(const FTransform& Trans
 	{
 		Normal = FVector::ZeroVector;
 		Impact = End;
-		Distance = (NormalizedTransform.GetLocation() - Impact).Size();
+		Distance = (Space.GetLocation() - Impact).Size();
 		return 1.f;
 	}
 
@@ -165,37 +324,233 @@ float FRigUnit_EllipsoidRaycast::ComputeEllispoidRaycast(const FTransform& Trans
 	Impact = Normal * Radius;
 
 	// Transform back to world
-	Normal = NormalizedTransform.TransformVectorNoScale((Normal / NormalizedTransform.GetScale3D())).GetSafeNormal();
-	Impact = NormalizedTransform.TransformPosition(Impact);
+	Normal = Space.TransformNormal(Normal).GetSafeNormal();
+	Impact = Space.TransformPosition(Impact);
 
 	Distance = RaySphereDistance - Radius;
 	return Time;
 }
 
+// Inverse transform rows (3 entries each for 4 rows), radius and square radius
+static constexpr int32 EllipsoidBatchEntries = 14;
+static constexpr int32 EllipsoidBatchRadius = 12;
+static constexpr int32 EllipsoidBatchRadiusSquared = 13;
+
+FORCEINLINE int32 EllipsoidBatchLane(int32 Index, int32 Entry)
+{
+	return ((Index / 4) * EllipsoidBatchEntries + Entry) * 4 + (Index % 4);
+}
+
+void FEllipsoidBatch::Reset(int32 InNum)
+{
+	Num = InNum;
+
+	// Unused lanes have zero radius and never hit
+	const int32 BlockNum = (Num + 3) / 4;
+	Lanes.SetNumUninitialized(BlockNum * EllipsoidBatchEntries * 4, false);
+	FMemory::Memzero(Lanes.GetData(), Lanes.Num() * sizeof(float));
+}
+
+void FEllipsoidBatch::Set(int32 Index, const FTransform& Transform, float Radius)
+{
+	// Same scale clamping as ComputeEllispoidRaycast
+	const FTransform NormalizedTransform = ClampEllipsoidScale(Transform);
+
+	const FMatrix Inverse = NormalizedTransform.ToInverseMatrixWithScale();
+	for (int32 Row = 0; Row < 4; Row++)
+	{
+		for (int32 Col = 0; Col < 3; Col++)
+		{
+			Lanes[EllipsoidBatchLane(Index, Row * 3 + Col)] = static_cast<float>(Inverse.M[Row][Col]);
+		}
+	}
+
+	Lanes[EllipsoidBatchLane(Index, EllipsoidBatchRadius)] = Radius;
+	Lanes[EllipsoidBatchLane(Index, EllipsoidBatchRadiusSquared)] = Radius * Radius;
+}
+
+void FEllipsoidBatch::Raycast(TConstArrayView<FVector> Starts, TConstArrayView<FVector> Ends, TArrayView<float> Times, TArrayView<int32> Hits) const
+{
+	check(Ends.Num() == Starts.Num() && Times.Num() == Starts.Num() && Hits.Num() == Starts.Num());
+	const int32 RayNum = Starts.Num();
+
+	const int32 BlockNum = Lanes.Num() / (EllipsoidBatchEntries * 4);
+	const VectorRegister4Float Zero = VectorZeroFloat();
+	const VectorRegister4Float Tolerance = VectorSetFloat1(0.01f);
+	const VectorRegister4Float MinLength = VectorSetFloat1(UE_KINDA_SMALL_NUMBER);
+
+	for (int32 RayIndex = 0; RayIndex < RayNum; RayIndex++)
+	{
+		const VectorRegister4Float StartX = VectorSetFloat1(static_cast<float>(Starts[RayIndex].X));
+		const VectorRegister4Float StartY = VectorSetFloat1(static_cast<float>(Starts[RayIndex].Y));
+		const VectorRegister4Float StartZ = VectorSetFloat1(static_cast<float>(Starts[RayIndex].Z));
+		const VectorRegister4Float EndX = VectorSetFloat1(static_cast<float>(Ends[RayIndex].X));
+		const VectorRegister4Float EndY = VectorSetFloat1(static_cast<float>(Ends[RayIndex].Y));
+		const VectorRegister4Float EndZ = VectorSetFloat1(static_cast<float>(Ends[RayIndex].Z));
+
+		float BestTime = 1.0f;
+		int32 BestHit = INDEX_NONE;
+		for (int32 Block = 0; Block < BlockNum; Block++)
+		{
+			const float* Data = Lanes.GetData() + Block * EllipsoidBatchEntries * 4;
+			auto Load = [Data](int32 Entry) { return VectorLoad(Data + Entry * 4); };
+
+			// Ray into ellipsoid space of all 4 ellipsoids
+			const VectorRegister4Float M00 = Load(0), M01 = Load(1), M02 = Load(2);
+			const VectorRegister4Float M10 = Load(3), M11 = Load(4), M12 = Load(5);
+			const VectorRegister4Float M20 = Load(6), M21 = Load(7), M22 = Load(8);
+			const VectorRegister4Float M30 = Load(9), M31 = Load(10), M32 = Load(11);
+
+			const VectorRegister4Float RayStartX = VectorMultiplyAdd(StartZ, M20, VectorMultiplyAdd(StartY, M10, VectorMultiplyAdd(StartX, M00, M30)));
+			const VectorRegister4Float RayStartY = VectorMultiplyAdd(StartZ, M21, VectorMultiplyAdd(StartY, M11, VectorMultiplyAdd(StartX, M01, M31)));
+			const VectorRegister4Float RayStartZ = VectorMultiplyAdd(StartZ, M22, VectorMultiplyAdd(StartY, M12, VectorMultiplyAdd(StartX, M02, M32)));
+			const VectorRegister4Float RayDeltaX = VectorSubtract(VectorMultiplyAdd(EndZ, M20, VectorMultiplyAdd(EndY, M10, VectorMultiplyAdd(EndX, M00, M30))), RayStartX);
+			const VectorRegister4Float RayDeltaY = VectorSubtract(VectorMultiplyAdd(EndZ, M21, VectorMultiplyAdd(EndY, M11, VectorMultiplyAdd(EndX, M01, M31))), RayStartY);
+			const VectorRegister4Float RayDeltaZ = VectorSubtract(VectorMultiplyAdd(EndZ, M22, VectorMultiplyAdd(EndY, M12, VectorMultiplyAdd(EndX, M02, M32))), RayStartZ);
+
+			const VectorRegister4Float RayLength = VectorSqrt(VectorMultiplyAdd(RayDeltaZ, RayDeltaZ, VectorMultiplyAdd(RayDeltaY, RayDeltaY, VectorMultiply(RayDeltaX, RayDeltaX))));
+			const VectorRegister4Float InvLength = VectorDivide(VectorOneFloat(), VectorMax(RayLength, MinLength));
+			const VectorRegister4Float RayDirX = VectorMultiply(RayDeltaX, InvLength);
+			const VectorRegister4Float RayDirY = VectorMultiply(RayDeltaY, InvLength);
+			const VectorRegister4Float RayDirZ = VectorMultiply(RayDeltaZ, InvLength);
+
+			// Sphere intersection
+			const VectorRegister4Float Sq = VectorMultiplyAdd(RayStartZ, RayStartZ, VectorMultiplyAdd(RayStartY, RayStartY, VectorMultiply(RayStartX, RayStartX)));
+			const VectorRegister4Float Rd = VectorSubtract(Sq, Load(EllipsoidBatchRadiusSquared));
+
+			VectorRegister4Float Value = VectorNegate(VectorMultiplyAdd(RayDirZ, RayStartZ, VectorMultiplyAdd(RayDirY, RayStartY, VectorMultiply(RayDirX, RayStartX))));
+			const VectorRegister4Float Discr = VectorSubtract(VectorMultiply(Value, Value), Rd);
+			Value = VectorSelect(VectorCompareGE(Discr, Zero), VectorSubtract(Value, VectorSqrt(VectorMax(Discr, Zero))), Value);
+
+			// Cast location on the sphere, restrict by raylength
+			const VectorRegister4Float Clamped = VectorMin(VectorMax(Value, Zero), RayLength);
+			const VectorRegister4Float PointX = VectorMultiplyAdd(RayDirX, Clamped, RayStartX);
+			const VectorRegister4Float PointY = VectorMultiplyAdd(RayDirY, Clamped, RayStartY);
+			const VectorRegister4Float PointZ = VectorMultiplyAdd(RayDirZ, Clamped, RayStartZ);
+			const VectorRegister4Float PointDistance = VectorSqrt(VectorMultiplyAdd(PointZ, PointZ, VectorMultiplyAdd(PointY, PointY, VectorMultiply(PointX, PointX))));
+			const VectorRegister4Float Distance = VectorSubtract(PointDistance, Load(EllipsoidBatchRadius));
+
+			const VectorRegister4Float Mask = VectorBitwiseAnd(
+				VectorBitwiseAnd(VectorCompareLT(Distance, Tolerance), VectorCompareGT(Load(EllipsoidBatchRadius), Zero)),
+				VectorCompareGT(RayLength, MinLength));
+
+			const int32 HitMask = VectorMaskBits(Mask);
+			if (HitMask != 0)
+			{
+				float LaneTimes[4];
+				VectorStore(VectorMultiply(Value, InvLength), LaneTimes);
+				for (int32 Lane = 0; Lane < 4; Lane++)
+				{
+					if ((HitMask & (1 << Lane)) && LaneTimes[Lane] < BestTime)
+					{
+						BestTime = LaneTimes[Lane];
+						BestHit = Block * 4 + Lane;
+					}
+				}
+			}
+		}
+
+		Times[RayIndex] = BestTime;
+		Hits[RayIndex] = BestHit;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void FEllipsoidColliderSet::Reset(int32 InNum)
+{
+	Transforms.SetNumUninitialized(InNum, false);
+	Radii.SetNumUninitialized(InNum, false);
+	BoundCenters.SetNumUninitialized(InNum, false);
+	BoundRadii.SetNumUninitialized(InNum, false);
+	Valid.SetNumUninitialized(InNum, false);
+	Spaces.SetNum(InNum, false);
+	Batch.Reset(InNum);
+
+	for (int32 Index = 0; Index < InNum; Index++)
+	{
+		Transforms[Index] = FTransform::Identity;
+		Radii[Index] = 0.0f;
+		BoundCenters[Index] = FVector::ZeroVector;
+		BoundRadii[Index] = 0.0f;
+		Valid[Index] = false;
+		Spaces[Index] = FEllipsoidSpace();
+	}
+}
+
+void FEllipsoidColliderSet::Set(int32 Index, const FTransform& Transform, float Radius)
+{
+	const FTransform NormalizedTransform = ClampEllipsoidScale(Transform);
+	Transforms[Index] = NormalizedTransform;
+	Radii[Index] = Radius;
+	BoundCenters[Index] = NormalizedTransform.GetLocation();
+	BoundRadii[Index] = Radius * NormalizedTransform.GetScale3D().GetAbsMax();
+	Valid[Index] = true;
+	Spaces[Index] = FEllipsoidSpace(NormalizedTransform);
+	Batch.Set(Index, NormalizedTransform, Radius);
+}
+
+FRigUnit_EllipsoidColliderSet_Execute()
+{
+	DECLARE_SCOPE_HIERARCHICAL_COUNTER_RIGUNIT();
+	ANGRY_RIGUNIT_TRACE_SCOPE(EllipsoidColliderSet);
+	const URigHierarchy* Hierarchy = ExecuteContext.Hierarchy;
+
+	if (!Hierarchy)
+	{
+		return;
+	}
+
+	const int32 EllipsoidNum = Ellipsoids.Num();
+	if (EllipsoidNum != EllipsoidCaches.Num())
+	{
+		EllipsoidCaches.SetNumZeroed(EllipsoidNum);
+	}
+
+	ColliderSet.Reset(EllipsoidNum);
+	for (int32 Index = 0; Index < EllipsoidNum; Index++)
+	{
+		FCachedRigElement& EllipsoidCache = EllipsoidCaches[Index];
+		const FEllipsoid& Ellipsoid = Ellipsoids[Index];
+
+		if (!EllipsoidCache.UpdateCache(Ellipsoid.Key, Hierarchy))
+		{
+			UE_CONTROLRIG_RIGUNIT_REPORT_WARNING(TEXT("key '%s' is not valid."), *Ellipsoid.Key.ToString());
+		}
+		else
+		{
+			ColliderSet.Set(Index, Hierarchy->GetGlobalTransform(EllipsoidCache), Ellipsoid.Radius);
+		}
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
 FRigUnit_EllipsoidRaycast_Execute()
 {
 	DECLARE_SCOPE_HIERARCHICAL_COUNTER_RIGUNIT();
+	ANGRY_RIGUNIT_TRACE_SCOPE(EllipsoidRaycast);
 	const URigHierarchy* Hierarchy = ExecuteContext.Hierarchy;
-	FRigVMDrawInterface* DrawInterface = ExecuteContext.GetDrawInterface();
+	FRigVMDrawInterface* DrawInterface = DebugSettings.IsEnabled() ? ExecuteContext.GetDrawInterface() : nullptr;
 
 	if (!Hierarchy)
 	{
 		return;
 	}
 
-	if (!EllipsoidCache.UpdateCache(Ellipsoid.Key, Hierarchy))
+	FEllipsoidSpace Space;
+	float Radius;
+	if (!ResolveEllipsoid(Hierarchy, Ellipsoid, EllipsoidCache, ColliderSet, ColliderIndex, Space, Radius))
 	{
-		UE_CONTROLRIG_RIGUNIT_REPORT_WARNING(TEXT("key '%s' is not valid."), *Ellipsoid.Key.ToString());
+		UE_CONTROLRIG_RIGUNIT_REPORT_WARNING(TEXT("%s is not valid."), *DescribeEllipsoid(Ellipsoid, ColliderIndex));
 	}
 	else
 	{
-		const FTransform Transform = Hierarchy->GetGlobalTransform(EllipsoidCache);
-
-		Time = ComputeEllispoidRaycast(Transform, Ellipsoid.Radius, Start, End, Impact, Normal, Distance);
+		Time = ComputeEllispoidRaycast(Space, Radius, Start, End, Impact, Normal, Distance);
 		Location = Distance < 0.01f ? Impact : End;
 		Time = Distance < 0.01f ? Time : 1.0f;
 
-		if (DebugSettings.bEnabled)
+		if (DebugSettings.IsEnabled())
 		{
 			DrawInterface->DrawLine(FTransform::Identity, Impact, Impact + Normal * 25.0f, FLinearColor::Red, DebugSettings.Scale * 0.1f);
 		}
@@ -207,49 +562,84 @@ FRigUnit_EllipsoidRaycast_Execute()
 FRigUnit_EllipsoidRaycastMulti_Execute()
 {
 	DECLARE_SCOPE_HIERARCHICAL_COUNTER_RIGUNIT();
+	ANGRY_RIGUNIT_TRACE_SCOPE(EllipsoidRaycastMulti);
 	const URigHierarchy* Hierarchy = ExecuteContext.Hierarchy;
-	FRigVMDrawInterface* DrawInterface = ExecuteContext.GetDrawInterface();
+	FRigVMDrawInterface* DrawInterface = DebugSettings.IsEnabled() ? ExecuteContext.GetDrawInterface() : nullptr;
 
 	if (!Hierarchy)
 	{
 		return;
 	}
 
-	const int32 EllipsoidNum = Ellipsoids.Num();
-	if (EllipsoidNum != EllipsoidCaches.Num())
-	{
-		EllipsoidCaches.SetNumZeroed(EllipsoidNum);
-	}
-
 	Time = 1.0f;
 	Impact = End;
 	Normal = FVector::UpVector;
 
-	for (int32 Index = 0; Index < EllipsoidNum; Index++)
+	// Prepared ellipsoids skip the hierarchy entirely
+	const bool bUseColliderSet = ColliderSet.Num() > 0;
+	const int32 EllipsoidNum = bUseColliderSet ? ColliderSet.Num() : Ellipsoids.Num();
+	if (!bUseColliderSet)
 	{
-		FCachedRigElement& EllipsoidCache = EllipsoidCaches[Index];
-		const FEllipsoid& Ellipsoid = Ellipsoids[Index];
-
-		if (!EllipsoidCache.UpdateCache(Ellipsoid.Key, Hierarchy))
+		if (EllipsoidNum != EllipsoidCaches.Num())
 		{
-			UE_CONTROLRIG_RIGUNIT_REPORT_WARNING(TEXT("key '%s' is not valid."), *Ellipsoid.Key.ToString());
+			EllipsoidCaches.SetNumZeroed(EllipsoidNum);
 		}
-		else
+
+		WorkData.EllipsoidBatch.Reset(EllipsoidNum);
+		for (int32 Index = 0; Index < EllipsoidNum; Index++)
 		{
-			const FTransform Transform = Hierarchy->GetGlobalTransform(EllipsoidCache);
+			FCachedRigElement& EllipsoidCache = EllipsoidCaches[Index];
+			const FEllipsoid& Ellipsoid = Ellipsoids[Index];
 
-			float CurrDistance;
-			FVector CurrImpact, CurrNormal;
-			const float CurrTime = FRigUnit_EllipsoidRaycast::ComputeEllispoidRaycast(Transform, Ellipsoid.Radius, Start, End, CurrImpact, CurrNormal, CurrDistance);
-			if (CurrDistance < 0.01f && CurrTime < Time)
+			if (!EllipsoidCache.UpdateCache(Ellipsoid.Key, Hierarchy))
 			{
-				Time = CurrTime;
-				Impact = CurrImpact;
-				Normal = CurrNormal;
+				UE_CONTROLRIG_RIGUNIT_REPORT_WARNING(TEXT("key '%s' is not valid."), *Ellipsoid.Key.ToString());
 			}
+			else
+			{
+				WorkData.EllipsoidBatch.Set(Index, Hierarchy->GetGlobalTransform(EllipsoidCache), Ellipsoid.Radius);
+			}
+		}
+	}
+
+	auto IsEllipsoidValid = [&](int32 Index)
+	{
+		return bUseColliderSet ? ColliderSet.IsValidIndex(Index) : EllipsoidCaches[Index].IsValid();
+	};
+
+	auto GetEllipsoid = [&](int32 Index, float& Radius)
+	{
+		Radius = bUseColliderSet ? ColliderSet.Radii[Index] : Ellipsoids[Index].Radius;
+		return bUseColliderSet ? ColliderSet.Spaces[Index] : FEllipsoidSpace(ClampEllipsoidScale(Hierarchy->GetGlobalTransform(EllipsoidCaches[Index])));
+	};
+
+	float HitTime = 1.0f;
+	int32 Hit = INDEX_NONE;
+	const FEllipsoidBatch& Batch = bUseColliderSet ? ColliderSet.Batch : WorkData.EllipsoidBatch;
+	Batch.Raycast(MakeArrayView(&Start, 1), MakeArrayView(&End, 1), MakeArrayView(&HitTime, 1), MakeArrayView(&Hit, 1));
+
+	// Only compute impact for the nearest hit
+	if (Hit != INDEX_NONE)
+	{
+		float Radius;
+		const FEllipsoidSpace Space = GetEllipsoid(Hit, Radius);
 
-			if (DebugSettings.bEnabled)
+		float CurrDistance;
+		Time = FRigUnit_EllipsoidRaycast::ComputeEllispoidRaycast(Space, Radius, Start, End, Impact, Normal, CurrDistance);
+	}
+
+	if (DebugSettings.IsEnabled())
+	{
+		for (int32 Index = 0; Index < EllipsoidNum; Index++)
+		{
+			if (IsEllipsoidValid(Index))
 			{
+				float Radius;
+				const FEllipsoidSpace Space = GetEllipsoid(Index, Radius);
+
+				float CurrDistance;
+				FVector CurrImpact, CurrNormal;
+				FRigUnit_EllipsoidRaycast::ComputeEllispoidRaycast(Space, Radius, Start, End, CurrImpact, CurrNormal, CurrDistance);
 				DrawInterface->DrawLine(FTransform::Identity, CurrImpact, CurrImpact + CurrNormal * 25.0f, FLinearColor::Red, DebugSettings.Scale * 0.1f);
 			}
 		}
@@ -258,36 +648,124 @@ FRigUnit_EllipsoidRaycastMulti_Execute()
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+// Spring integration step and the most steps taken per update, slow frames lose time instead of stalling further
+static constexpr float SpringBatchStep = 1.0f / 120.0f;
+static constexpr int32 SpringBatchMaxSteps = 16;
+
+void FSpringBatch::Reset(int32 Num, float Value)
+{
+	Targets.Init(Value, Num);
+	PreviousTargets.Init(Value, Num);
+	Values.Init(Value, Num);
+	PreviousValues.Init(Value, Num);
+	Velocities.Init(0.0f, Num);
+	Accumulator = 0.0f;
+	bHasTargets = false;
+}
+
+void FSpringBatch::Update(float DeltaTime, float Stiffness, float Damping)
+{
+	if (DeltaTime <= UE_SMALL_NUMBER)
+	{
+		return;
+	}
+
+	const int32 Num = Values.Num();
+	if (!bHasTargets)
+	{
+		PreviousTargets = Targets;
+		bHasTargets = true;
+	}
+
+	// Targets are constant during the update, their motion over the frame feeds into damping
+	const float Omega = FMath::Sqrt(FMath::Max(Stiffness, 0.0f));
+	const float Spring = Omega * Omega;
+	const float Friction = 2.0f * Damping * Omega;
+	const float InvDeltaTime = 1.0f / DeltaTime;
+
+	Accumulator = FMath::Min(Accumulator + DeltaTime, SpringBatchStep * SpringBatchMaxSteps);
+	while (Accumulator >= SpringBatchStep)
+	{
+		Accumulator -= SpringBatchStep;
+		FMemory::Memcpy(PreviousValues.GetData(), Values.GetData(), Num * sizeof(float));
+
+		// Semi-implicit Euler, plain arrays so this can be vectorised
+		float* RESTRICT ValueData = Values.GetData();
+		float* RESTRICT VelocityData = Velocities.GetData();
+		const float* RESTRICT TargetData = Targets.GetData();
+		const float* RESTRICT PreviousTargetData = PreviousTargets.GetData();
+		for (int32 Index = 0; Index < Num; Index++)
+		{
+			const float TargetVelocity = (TargetData[Index] - PreviousTargetData[Index]) * InvDeltaTime;
+			const float Acceleration = (TargetData[Index] - ValueData[Index]) * Spring + (TargetVelocity - VelocityData[Index]) * Friction;
+			VelocityData[Index] += Acceleration * SpringBatchStep;
+			ValueData[Index] += VelocityData[Index] * SpringBatchStep;
+		}
+	}
+
+	FMemory::Memcpy(PreviousTargets.GetData(), Targets.GetData(), Num * sizeof(float));
+}
+
+float FSpringBatch::GetValue(int32 Index) const
+{
+	return FMath::Lerp(PreviousValues[Index], Values[Index], Accumulator / SpringBatchStep);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Neighbours with less influence than this are ignored
+static constexpr float RingCastKernelCutoff = 0.001f;
+
 FRigUnit_EllipsoidRingCast_Execute()
 {
 	DECLARE_SCOPE_HIERARCHICAL_COUNTER_RIGUNIT();
+	ANGRY_RIGUNIT_TRACE_SCOPE(EllipsoidRingCast);
 	URigHierarchy* Hierarchy = ExecuteContext.Hierarchy;
-	FRigVMDrawInterface* DrawInterface = ExecuteContext.GetDrawInterface();
+	FRigVMDrawInterface* DrawInterface = DebugSettings.IsEnabled() ? ExecuteContext.GetDrawInterface() : nullptr;
 
 	if (!Hierarchy)
 	{
 		return;
 	}
 
-	const int32 EllipsoidNum = Ellipsoids.Num();
-	if (EllipsoidNum != WorkData.EllipsoidCaches.Num())
-	{
-		WorkData.EllipsoidCaches.SetNumZeroed(EllipsoidNum);
-	}
-
 	const int32 ItemNum = Items.Num();
 	if (ItemNum != WorkData.ItemCaches.Num())
 	{
 		WorkData.ItemCaches.SetNumZeroed(ItemNum);
-		for (int32 ItemIndex = 0; ItemIndex < ItemNum; ItemIndex++)
+		WorkData.Springs.Reset(ItemNum, 1.0f);
+	}
+
+	// Prepared ellipsoids skip the hierarchy entirely
+	const bool bUseColliderSet = ColliderSet.Num() > 0;
+	if (!bUseColliderSet)
+	{
+		const int32 EllipsoidNum = Ellipsoids.Num();
+		if (EllipsoidNum != WorkData.EllipsoidCaches.Num())
+		{
+			WorkData.EllipsoidCaches.SetNumZeroed(EllipsoidNum);
+		}
+
+		WorkData.EllipsoidBatch.Reset(EllipsoidNum);
+		for (int32 EllipsoidIndex = 0; EllipsoidIndex < EllipsoidNum; EllipsoidIndex++)
 		{
-			FRigUnit_EllipsoidRingCastItem_WorkData& ItemCache = WorkData.ItemCaches[ItemIndex];
-			UKismetMathLibrary::ResetFloatSpringState(ItemCache.SpringState);
-			ItemCache.bIsInitialised = false;
-			ItemCache.CurrentTime = 1.f;
+			FCachedRigElement& EllipsoidCache = WorkData.EllipsoidCaches[EllipsoidIndex];
+			const FEllipsoid& Ellipsoid = Ellipsoids[EllipsoidIndex];
+
+			if (!EllipsoidCache.UpdateCache(Ellipsoid.Key, Hierarchy))
+			{
+				UE_CONTROLRIG_RIGUNIT_REPORT_WARNING(TEXT("key '%s' is not valid."), *Ellipsoid.Key.ToString());
+			}
+			else
+			{
+				WorkData.EllipsoidBatch.Set(EllipsoidIndex, Hierarchy->GetGlobalTransform(EllipsoidCache), Ellipsoid.Radius);
+			}
 		}
 	}
 
+	WorkData.RayStarts.SetNumUninitialized(ItemNum, false);
+	WorkData.RayEnds.SetNumUninitialized(ItemNum, false);
+	WorkData.RayTimes.SetNumUninitialized(ItemNum, false);
+	WorkData.RayHits.SetNumUninitialized(ItemNum, false);
 	for (int32 ItemIndex = 0; ItemIndex < ItemNum; ItemIndex++)
 	{
 		const FRigElementKey& Item = Items[ItemIndex];
@@ -295,6 +773,9 @@ FRigUnit_EllipsoidRingCast_Execute()
 		if (!ItemCache.Cache.UpdateCache(Item, Hierarchy))
 		{
 			UE_CONTROLRIG_RIGUNIT_REPORT_WARNING(TEXT("key '%s' is not valid."), *Item.ToString());
+
+			// Zero length rays never hit
+			WorkData.RayStarts[ItemIndex] = WorkData.RayEnds[ItemIndex] = FVector::ZeroVector;
 		}
 		else
 		{
@@ -302,90 +783,170 @@ FRigUnit_EllipsoidRingCast_Execute()
 			const FVector End = ItemCache.Transform.GetLocation();
 			ItemCache.Delta = ItemCache.Transform.TransformVectorNoScale(CastAxis) * CastDistance;
 
-			ItemCache.TargetTime = 1.0f;
-			for (int32 EllipsoidIndex = 0; EllipsoidIndex < EllipsoidNum; EllipsoidIndex++)
-			{
-				FCachedRigElement& EllipsoidCache = WorkData.EllipsoidCaches[EllipsoidIndex];
-				const FEllipsoid& Ellipsoid = Ellipsoids[EllipsoidIndex];
+			WorkData.RayStarts[ItemIndex] = End + ItemCache.Delta;
+			WorkData.RayEnds[ItemIndex] = End;
+		}
+	}
 
-				if (!EllipsoidCache.UpdateCache(Ellipsoid.Key, Hierarchy))
-				{
-					UE_CONTROLRIG_RIGUNIT_REPORT_WARNING(TEXT("key '%s' is not valid."), *Ellipsoid.Key.ToString());
-				}
-				else
-				{
-					const FTransform Transform = Hierarchy->GetGlobalTransform(EllipsoidCache);
+	const FEllipsoidBatch& Batch = bUseColliderSet ? ColliderSet.Batch : WorkData.EllipsoidBatch;
+	Batch.Raycast(WorkData.RayStarts, WorkData.RayEnds, WorkData.RayTimes, WorkData.RayHits);
 
-					float CurrDistance;
-					FVector CurrImpact, CurrNormal;
-					const float CurrTime = FRigUnit_EllipsoidRaycast::ComputeEllispoidRaycast(Transform, Ellipsoid.Radius, End + ItemCache.Delta, End, CurrImpact, CurrNormal, CurrDistance);
-					if (CurrDistance < 0.01f && CurrTime < ItemCache.TargetTime)
-					{
-						ItemCache.TargetTime = CurrTime;
-					}
-				}
-			}
+	for (int32 ItemIndex = 0; ItemIndex < ItemNum; ItemIndex++)
+	{
+		FRigUnit_EllipsoidRingCastItem_WorkData& ItemCache = WorkData.ItemCaches[ItemIndex];
+		if (ItemCache.Cache.IsValid())
+		{
+			ItemCache.TargetTime = WorkData.RayTimes[ItemIndex];
 
-			if (DebugSettings.bEnabled)
+			if (DebugSettings.IsEnabled())
 			{
+				const FVector End = WorkData.RayEnds[ItemIndex];
 				DrawInterface->DrawLine(FTransform::Identity, End + ItemCache.Delta, End, FLinearColor::Red, DebugSettings.Scale * 0.1f);
 				DrawInterface->DrawPoint(FTransform::Identity, FMath::Lerp(End + ItemCache.Delta, End, ItemCache.TargetTime), DebugSettings.Scale * 5.0f, FLinearColor::Green);
 			}
 		}
 	}
 
-	for (int32 ItemIndex = 0; ItemIndex < ItemNum; ItemIndex++)
+	// Neighbour weights only depend on index offset, wrapping around the ring
+	if (WorkData.KernelItemNum != ItemNum || WorkData.KernelVariance != SpreadVariance)
 	{
-		FRigUnit_EllipsoidRingCastItem_WorkData& ItemCache = WorkData.ItemCaches[ItemIndex];
-		if (ItemCache.Cache.IsValid())
+		WorkData.KernelItemNum = ItemNum;
+		WorkData.KernelVariance = SpreadVariance;
+		WorkData.KernelBands.Reset();
+		WorkData.KernelOffsets.Reset();
+		WorkData.KernelWeights.Reset();
+
+		// Each of the three gaussians is below a third of the cutoff outside this many items
+		const float Variance = FMath::Max(SpreadVariance, KINDA_SMALL_NUMBER);
+		const int32 Reach = FMath::CeilToInt(ItemNum * FMath::Sqrt(Variance * -FMath::Loge(RingCastKernelCutoff / 3.0f)));
+
+		int32 BandStart = INDEX_NONE;
+		for (int32 Offset = 1 - ItemNum; Offset < ItemNum; Offset++)
 		{
-			float ConstrainedTime = 1.f;
-
-			const float ItemRatio = ((float)ItemIndex) / ItemNum;
-			for (int32 OtherIndex = 0; OtherIndex < ItemNum; OtherIndex++)
+			float Weight = 0.0f;
+			if (FMath::Min3(FMath::Abs(Offset + ItemNum), FMath::Abs(Offset), FMath::Abs(Offset - ItemNum)) <= Reach)
 			{
-				const FRigUnit_EllipsoidRingCastItem_WorkData& OtherCache = WorkData.ItemCaches[OtherIndex];
-				if (OtherCache.Cache.IsValid())
-				{
-					const float OtherRatio = ((float)OtherIndex) / ItemNum;
+				const float Ratio = ((float)Offset) / ItemNum;
 
-					const float Value =
-						FMath::Exp(FMath::Square(OtherRatio - (ItemRatio - 1.0f)) / -SpreadVariance) +
-						FMath::Exp(FMath::Square(OtherRatio - (ItemRatio + 0.0f)) / -SpreadVariance) +
-						FMath::Exp(FMath::Square(OtherRatio - (ItemRatio + 1.0f)) / -SpreadVariance);
+				const float Value =
+					FMath::Exp(FMath::Square(Ratio + 1.0f) / -Variance) +
+					FMath::Exp(FMath::Square(Ratio + 0.0f) / -Variance) +
+					FMath::Exp(FMath::Square(Ratio - 1.0f) / -Variance);
 
-					ConstrainedTime = FMath::Min(ConstrainedTime, FMath::Lerp(1.0f, OtherCache.TargetTime, FMath::Clamp(Value, 0.f, 1.f)));
-				}
+				Weight = FMath::Clamp(Value, 0.f, 1.f);
 			}
 
-			/*if (ConstrainedTime < ItemCache.CurrentTime)
+			if (Weight >= 1.0f)
 			{
-				ItemCache.CurrentTime = ConstrainedTime;
-				ItemCache.SpringState.Reset();
-			}*/
-
-			ItemCache.CurrentTime = UKismetMathLibrary::FloatSpringInterp(
-				ItemCache.CurrentTime, ConstrainedTime, ItemCache.SpringState,
-				SpringStrength, SpringDamping, ExecuteContext.GetDeltaTime(), 1.f, 1.f,
-				false, -1, 1, ItemCache.bIsInitialised);
-			ItemCache.bIsInitialised = true;
+				BandStart = BandStart == INDEX_NONE ? Offset : BandStart;
+				continue;
+			}
 
-			ItemCache.Transform.AddToTranslation((1.0f - ItemCache.CurrentTime) * ItemCache.Delta);
-			Hierarchy->SetGlobalTransform(ItemCache.Cache.GetKey(), ItemCache.Transform, false, true);
+			if (BandStart != INDEX_NONE)
+			{
+				WorkData.KernelBands.Emplace(BandStart, Offset - 1);
+				BandStart = INDEX_NONE;
+			}
+
+			if (Weight > RingCastKernelCutoff)
+			{
+				WorkData.KernelOffsets.Emplace(Offset);
+				WorkData.KernelWeights.Emplace(Weight);
+			}
+		}
+
+		if (BandStart != INDEX_NONE)
+		{
+			WorkData.KernelBands.Emplace(BandStart, ItemNum - 1);
+		}
+	}
+
+	// Invalid items never constrain their neighbours
+	TArray<float>& Times = WorkData.KernelTimes;
+	Times.SetNumUninitialized(ItemNum, false);
+	for (int32 ItemIndex = 0; ItemIndex < ItemNum; ItemIndex++)
+	{
+		const FRigUnit_EllipsoidRingCastItem_WorkData& ItemCache = WorkData.ItemCaches[ItemIndex];
+		Times[ItemIndex] = ItemCache.Cache.IsValid() ? ItemCache.TargetTime : 1.0f;
+		WorkData.Springs.Targets[ItemIndex] = 1.0f;
+	}
+
+	// Full weight neighbours are a plain minimum over a window moving with the item, use a monotonic queue
+	WorkData.KernelQueue.SetNumUninitialized(ItemNum, false);
+	int32* Queue = WorkData.KernelQueue.GetData();
+	for (const FIntPoint& Band : WorkData.KernelBands)
+	{
+		int32 Head = 0;
+		int32 Tail = 0;
+		int32 Next = 0;
+		for (int32 ItemIndex = 0; ItemIndex < ItemNum; ItemIndex++)
+		{
+			const int32 First = FMath::Max(ItemIndex + Band.X, 0);
+			const int32 Last = FMath::Min(ItemIndex + Band.Y, ItemNum - 1);
+
+			for (; Next <= Last; Next++)
+			{
+				while (Tail > Head && Times[Queue[Tail - 1]] >= Times[Next])
+				{
+					Tail--;
+				}
+				Queue[Tail++] = Next;
+			}
+
+			while (Head < Tail && Queue[Head] < First)
+			{
+				Head++;
+			}
+
+			if (Head < Tail)
+			{
+				WorkData.Springs.Targets[ItemIndex] = FMath::Min(WorkData.Springs.Targets[ItemIndex], Times[Queue[Head]]);
+			}
+		}
+	}
+
+	// Only the tail of the kernel needs to be weighted
+	const int32 KernelNum = WorkData.KernelOffsets.Num();
+	for (int32 ItemIndex = 0; ItemIndex < ItemNum; ItemIndex++)
+	{
+		float ConstrainedTime = 1.f;
+		if (WorkData.ItemCaches[ItemIndex].Cache.IsValid())
+		{
+			ConstrainedTime = WorkData.Springs.Targets[ItemIndex];
+			for (int32 KernelIndex = 0; KernelIndex < KernelNum; KernelIndex++)
+			{
+				const int32 OtherIndex = ItemIndex + WorkData.KernelOffsets[KernelIndex];
+				if (OtherIndex >= 0 && OtherIndex < ItemNum)
+				{
+					ConstrainedTime = FMath::Min(ConstrainedTime, FMath::Lerp(1.0f, Times[OtherIndex], WorkData.KernelWeights[KernelIndex]));
+				}
+			}
+		}
+		WorkData.Springs.Targets[ItemIndex] = ConstrainedTime;
+	}
+
+	WorkData.Springs.Update(ExecuteContext.GetDeltaTime(), SpringStrength, SpringDamping);
+
+	for (int32 ItemIndex = 0; ItemIndex < ItemNum; ItemIndex++)
+	{
+		FRigUnit_EllipsoidRingCastItem_WorkData& ItemCache = WorkData.ItemCaches[ItemIndex];
+		if (ItemCache.Cache.IsValid())
+		{
+			ItemCache.Transform.AddToTranslation((1.0f - WorkData.Springs.GetValue(ItemIndex)) * ItemCache.Delta);
+			FRigTracedWrite::SetGlobalTransform(Hierarchy, ItemCache.Cache.GetKey(), ItemCache.Transform, false, true);
 		}
 	}
 }
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
-FVector FRigUnit_EllipsoidLineCollide::ComputeEllispoidLineCollide(const FTransform& Transform, float Radius, const FVector& Start, const FVector& End, const FVector& Direction, float Adapt)
+// Tangent from the line start to the circle the line end sweeps through the sphere, in ellipsoid space.
+// Returns false if the line isn't moved, Intensity is how much to lerp back to the original line
+static FORCEINLINE bool ComputeEllipsoidLineTangent(const FVector& RayStart, const FVector& RayEnd, const FVector& RayMove, float Radius, float Adapt, FVector& Tangent, float& Intensity)
 {
-	const FVector RayStart = Transform.InverseTransformPosition(Start);
-	const FVector RayEnd = Transform.InverseTransformPosition(End);
 	const FVector RayDelta = RayEnd - RayStart;
 	const float RayLength = RayDelta.Size();
 	const FVector RayDir = RayDelta / RayLength;
 
-	const FVector RayMove = Transform.InverseTransformVector(Direction);
 	const FVector RayAxis = (RayMove ^ RayDir).GetSafeNormal();
 
 	const float Ad = RayAxis | RayStart; // Distance between circle center to sphere
@@ -412,20 +973,46 @@ FVector FRigUnit_EllipsoidLineCollide::ComputeEllispoidLineCollide(const FTransf
 
 				const float Height = FMath::Sqrt(Dq * Pq) / Sd; // Triangle height (area / hypoth)
 				const float Kath = FMath::Sqrt(Dq - FMath::Square(Height));
-				const FVector Tangent = HN * Height + SN * Kath; // Tangent
+				Tangent = HN * Height + SN * Kath; // Tangent
 
-				const FVector TangentPoint = Transform.TransformPosition(RayStart + Tangent);
-				const FVector WorldDelta = End - Start;
-				const float WorldLength = WorldDelta.Size();
-				const FVector TangentDelta = TangentPoint - Start;
-
-				const float Intensity = FMath::Clamp(-Rq / (Adapt * Adapt), 0.0f, 1.0f);
-				const FVector Delta = FMath::Lerp(TangentDelta, WorldDelta, Intensity);
-				return Start + Delta.GetSafeNormal() * WorldLength;
+				Intensity = FMath::Clamp(-Rq / (Adapt * Adapt), 0.0f, 1.0f);
+				return true;
 			}
 		}
 	}
 
+	return false;
+}
+
+// Rotates the line towards the tangent point keeping its length
+static FORCEINLINE FVector DeflectEllipsoidLine(const FVector& Start, const FVector& End, const FVector& TangentPoint, float Intensity)
+{
+	const FVector WorldDelta = End - Start;
+	const float WorldLength = WorldDelta.Size();
+	const FVector TangentDelta = TangentPoint - Start;
+
+	const FVector Delta = FMath::Lerp(TangentDelta, WorldDelta, Intensity);
+	return Start + Delta.GetSafeNormal() * WorldLength;
+}
+
+FVector FRigUnit_EllipsoidLineCollide::ComputeEllispoidLineCollide(const FTransform& Transform, float Radius, const FVector& Start, const FVector& End, const FVector& Direction, float Adapt)
+{
+	return ComputeEllispoidLineCollide(FEllipsoidSpace(Transform), Radius, Start, End, Direction, Adapt);
+}
+
+FVector FRigUnit_EllipsoidLineCollide::ComputeEllispoidLineCollide(const FEllipsoidSpace& Space, float Radius, const FVector& Start, const FVector& End, const FVector& Direction, float Adapt)
+{
+	const FVector RayStart = Space.InverseTransformPosition(Start);
+	const FVector RayEnd = Space.InverseTransformPosition(End);
+	const FVector RayMove = Space.InverseTransformVector(Direction);
+
+	FVector Tangent;
+	float Intensity;
+	if (ComputeEllipsoidLineTangent(RayStart, RayEnd, RayMove, Radius, Adapt, Tangent, Intensity))
+	{
+		return DeflectEllipsoidLine(Start, End, Space.TransformPosition(RayStart + Tangent), Intensity);
+	}
+
 	// Don't move by default
 	return End;
 }
@@ -433,24 +1020,26 @@ FVector FRigUnit_EllipsoidLineCollide::ComputeEllispoidLineCollide(const FTransf
 FRigUnit_EllipsoidLineCollide_Execute()
 {
 	DECLARE_SCOPE_HIERARCHICAL_COUNTER_RIGUNIT();
+	ANGRY_RIGUNIT_TRACE_SCOPE(EllipsoidLineCollide);
 	const URigHierarchy* Hierarchy = ExecuteContext.Hierarchy;
-	FRigVMDrawInterface* DrawInterface = ExecuteContext.GetDrawInterface();
+	FRigVMDrawInterface* DrawInterface = DebugSettings.IsEnabled() ? ExecuteContext.GetDrawInterface() : nullptr;
 
 	if (!Hierarchy)
 	{
 		return;
 	}
 
-	if (!EllipsoidCache.UpdateCache(Ellipsoid.Key, Hierarchy))
+	FEllipsoidSpace Space;
+	float Radius;
+	if (!ResolveEllipsoid(Hierarchy, Ellipsoid, EllipsoidCache, ColliderSet, ColliderIndex, Space, Radius))
 	{
-		UE_CONTROLRIG_RIGUNIT_REPORT_WARNING(TEXT("key '%s' is not valid."), *Ellipsoid.Key.ToString());
+		UE_CONTROLRIG_RIGUNIT_REPORT_WARNING(TEXT("%s is not valid."), *DescribeEllipsoid(Ellipsoid, ColliderIndex));
 	}
 	else
 	{
-		const FTransform Transform = Hierarchy->GetGlobalTransform(EllipsoidCache);
-		Deflect = ComputeEllispoidLineCollide(Transform, Ellipsoid.Radius, Start, End, Direction, Adapt);
+		Deflect = ComputeEllispoidLineCollide(Space, Radius, Start, End, Direction, Adapt);
 
-		if (DebugSettings.bEnabled)
+		if (DebugSettings.IsEnabled())
 		{
 			DrawInterface->DrawPoint(FTransform::Identity, Deflect, DebugSettings.Scale * 5.0f, FLinearColor::White);
 		}
@@ -459,36 +1048,496 @@ FRigUnit_EllipsoidLineCollide_Execute()
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+void FRigUnit_EllipsoidLineCollideMulti::ComputeEllispoidLineCollideBatch(const FEllipsoidSpace& Space, float Radius, TConstArrayView<FVector> Starts, TArrayView<FVector> Ends, TConstArrayView<FVector> Directions, float Adapt)
+{
+	check(Ends.Num() == Starts.Num() && Directions.Num() == Starts.Num());
+
+	// Collider set spaces are already scale clamped
+	const FMatrix& ToLocal = Space.ToLocal;
+	const FMatrix& ToWorld = Space.ToWorld;
+
+	const int32 LineNum = Starts.Num();
+	for (int32 Index = 0; Index < LineNum; Index++)
+	{
+		const FVector& Start = Starts[Index];
+		const FVector RayStart = ToLocal.TransformPosition(Start);
+		const FVector RayEnd = ToLocal.TransformPosition(Ends[Index]);
+		if (RayStart.Equals(RayEnd))
+		{
+			continue;
+		}
+
+		FVector Tangent;
+		float Intensity;
+		if (ComputeEllipsoidLineTangent(RayStart, RayEnd, ToLocal.TransformVector(Directions[Index]), Radius, Adapt, Tangent, Intensity))
+		{
+			Ends[Index] = DeflectEllipsoidLine(Start, Ends[Index], ToWorld.TransformPosition(RayStart + Tangent), Intensity);
+		}
+	}
+}
+
+void FRigUnit_EllipsoidLineCollideMulti_WorkData::Update(const URigHierarchy* Hierarchy)
+{
+	const int32 LineNum = PivotCaches.Num();
+
+	// Connectors and branches depend on parenting, not just on which elements are pivots
+	bool bChanged = TopologyVersion != Hierarchy->GetTopologyVersion() || PivotElements.Num() != LineNum;
+	TopologyVersion = Hierarchy->GetTopologyVersion();
+	PivotElements.SetNum(LineNum);
+	for (int32 Index = 0; Index < LineNum; Index++)
+	{
+		const int32 Element = PivotCaches[Index].IsValid() && TipCaches[Index].IsValid() ? PivotCaches[Index].GetIndex() : INDEX_NONE;
+		bChanged |= PivotElements[Index] != Element;
+		PivotElements[Index] = Element;
+	}
+
+	if (!bChanged)
+	{
+		return;
+	}
+
+	TMap<int32, int32> Segments;
+	for (int32 Index = 0; Index < LineNum; Index++)
+	{
+		if (PivotElements[Index] != INDEX_NONE)
+		{
+			Segments.Emplace(PivotElements[Index], Index);
+		}
+	}
+
+	// Closest pivot above each pivot, everything on the way there is a connector
+	TArray<int32> SegmentParents;
+	TArray<TArray<int32>> SegmentConnectors;
+	SegmentParents.Init(INDEX_NONE, LineNum);
+	SegmentConnectors.SetNum(LineNum);
+	for (int32 Index = 0; Index < LineNum; Index++)
+	{
+		if (PivotElements[Index] == INDEX_NONE)
+		{
+			continue;
+		}
+
+		TArray<int32> Path;
+		for (int32 Parent = Hierarchy->GetFirstParent(PivotElements[Index]); Parent != INDEX_NONE; Parent = Hierarchy->GetFirstParent(Parent))
+		{
+			if (const int32* Segment = Segments.Find(Parent))
+			{
+				SegmentParents[Index] = *Segment;
+				SegmentConnectors[Index] = MoveTemp(Path);
+				break;
+			}
+			Path.Emplace(Parent);
+		}
+	}
+
+	// Hierarchy is acyclic, so depth is well defined
+	TArray<int32> Depths;
+	Depths.Init(INDEX_NONE, LineNum);
+	int32 MaxDepth = 0;
+	for (int32 Index = 0; Index < LineNum; Index++)
+	{
+		if (PivotElements[Index] == INDEX_NONE)
+		{
+			continue;
+		}
+
+		int32 Depth = 0;
+		for (int32 Parent = SegmentParents[Index]; Parent != INDEX_NONE; Parent = SegmentParents[Parent])
+		{
+			Depth++;
+		}
+		Depths[Index] = Depth;
+		MaxDepth = FMath::Max(MaxDepth, Depth);
+	}
+
+	// Bucket by depth, keeping input order within each level
+	Order.Reset();
+	LevelOffsets.Reset();
+	for (int32 Depth = 0; Depth <= MaxDepth; Depth++)
+	{
+		LevelOffsets.Emplace(Order.Num());
+		for (int32 Index = 0; Index < LineNum; Index++)
+		{
+			if (Depths[Index] == Depth)
+			{
+				Order.Emplace(Index);
+			}
+		}
+	}
+	LevelOffsets.Emplace(Order.Num());
+
+	const int32 SlotNum = Order.Num();
+	TArray<int32> Slots;
+	Slots.Init(INDEX_NONE, LineNum);
+	for (int32 Slot = 0; Slot < SlotNum; Slot++)
+	{
+		Slots[Order[Slot]] = Slot;
+	}
+
+	TSet<int32> Written;
+	Parents.SetNumUninitialized(SlotNum);
+	Connectors.Reset();
+	ConnectorParents.Reset();
+	for (int32 Slot = 0; Slot < SlotNum; Slot++)
+	{
+		const int32 Segment = Order[Slot];
+		Parents[Slot] = SegmentParents[Segment] != INDEX_NONE ? Slots[SegmentParents[Segment]] : INDEX_NONE;
+		Written.Emplace(PivotElements[Segment]);
+
+		for (const int32 Connector : SegmentConnectors[Segment])
+		{
+			Connectors.Emplace(Connector);
+			ConnectorParents.Emplace(Parents[Slot]);
+			Written.Emplace(Connector);
+		}
+	}
+
+	// Branches never contain written elements, a path to a pivot would have made them a connector
+	Branches.Reset();
+	for (const int32 Element : Written)
+	{
+		for (const int32 Child : Hierarchy->GetChildren(Element))
+		{
+			if (!Written.Contains(Child))
+			{
+				Branches.Emplace(Child);
+			}
+		}
+	}
+
+	ConnectorTransforms.SetNumUninitialized(Connectors.Num());
+	BranchLocals.SetNumUninitialized(Branches.Num());
+	Initials.SetNumUninitialized(SlotNum);
+	Solved.SetNumUninitialized(SlotNum);
+	TipLocals.SetNumUninitialized(SlotNum);
+	Starts.SetNumUninitialized(SlotNum);
+	Tips.SetNumUninitialized(SlotNum);
+	Ends.SetNumUninitialized(SlotNum);
+	Directions.SetNumUninitialized(SlotNum);
+}
+
+FRigUnit_EllipsoidLineCollideMulti_Execute()
+{
+	DECLARE_SCOPE_HIERARCHICAL_COUNTER_RIGUNIT();
+	ANGRY_RIGUNIT_TRACE_SCOPE(EllipsoidLineCollideMulti);
+	URigHierarchy* Hierarchy = ExecuteContext.Hierarchy;
+
+	if (!Hierarchy)
+	{
+		return;
+	}
+
+	const int32 LineNum = Pivots.Num();
+	if (LineNum != Tips.Num())
+	{
+		UE_CONTROLRIG_RIGUNIT_REPORT_WARNING(TEXT("Pivots and tips need to have the same number of elements."));
+		return;
+	}
+
+	if (LineNum != WorkData.PivotCaches.Num())
+	{
+		WorkData.PivotCaches.SetNumZeroed(LineNum);
+		WorkData.TipCaches.SetNumZeroed(LineNum);
+	}
+
+	for (int32 Index = 0; Index < LineNum; Index++)
+	{
+		const bool bPivot = WorkData.PivotCaches[Index].UpdateCache(Pivots[Index], Hierarchy);
+		const bool bTip = WorkData.TipCaches[Index].UpdateCache(Tips[Index], Hierarchy);
+		if (!bPivot || !bTip)
+		{
+			UE_CONTROLRIG_RIGUNIT_REPORT_WARNING(TEXT("Segment %d contains invalid elements, it is skipped."), Index);
+		}
+	}
+	WorkData.Update(Hierarchy);
+
+	// Read everything before anything is written
+	const int32 SlotNum = WorkData.Order.Num();
+	for (int32 Slot = 0; Slot < SlotNum; Slot++)
+	{
+		const int32 Segment = WorkData.Order[Slot];
+		WorkData.Initials[Slot] = Hierarchy->GetGlobalTransform(WorkData.PivotCaches[Segment]);
+		WorkData.TipLocals[Slot] = WorkData.Initials[Slot].InverseTransformPosition(Hierarchy->GetGlobalTransform(WorkData.TipCaches[Segment]).GetLocation());
+	}
+
+	const int32 ConnectorNum = WorkData.Connectors.Num();
+	for (int32 Index = 0; Index < ConnectorNum; Index++)
+	{
+		WorkData.ConnectorTransforms[Index] = Hierarchy->GetGlobalTransform(WorkData.Connectors[Index]).GetRelativeTransform(WorkData.Initials[WorkData.ConnectorParents[Index]]);
+	}
+
+	const int32 BranchNum = WorkData.Branches.Num();
+	for (int32 Index = 0; Index < BranchNum; Index++)
+	{
+		WorkData.BranchLocals[Index] = Hierarchy->GetLocalTransform(WorkData.Branches[Index]);
+	}
+
+	// Only record debug primitives if enabled
+	FRigDebugBuffer* Debug = DebugSettings.IsEnabled() ? &WorkData.DebugBuffer : nullptr;
+
+	// Solve one level at a time, each segment starts where its solved parent put it
+	const int32 EllipsoidNum = ColliderSet.Num();
+	const int32 LevelNum = WorkData.LevelOffsets.Num() - 1;
+	for (int32 Level = 0; Level < LevelNum; Level++)
+	{
+		const int32 LevelStart = WorkData.LevelOffsets[Level];
+		const int32 LevelSize = WorkData.LevelOffsets[Level + 1] - LevelStart;
+
+		for (int32 Slot = LevelStart; Slot < LevelStart + LevelSize; Slot++)
+		{
+			const int32 Parent = WorkData.Parents[Slot];
+			const FTransform Pivot = Parent != INDEX_NONE ? WorkData.Initials[Slot].GetRelativeTransform(WorkData.Initials[Parent]) * WorkData.Solved[Parent] : WorkData.Initials[Slot];
+
+			WorkData.Solved[Slot] = Pivot;
+			WorkData.Starts[Slot] = Pivot.GetLocation();
+			WorkData.Tips[Slot] = WorkData.Ends[Slot] = Pivot.TransformPosition(WorkData.TipLocals[Slot]);
+			WorkData.Directions[Slot] = Pivot.TransformVectorNoScale(Direction);
+		}
+
+		// Each ellipsoid deflects every line of this level in turn
+		for (int32 EllipsoidIndex = 0; EllipsoidIndex < EllipsoidNum; EllipsoidIndex++)
+		{
+			if (ColliderSet.IsValidIndex(EllipsoidIndex))
+			{
+				ComputeEllispoidLineCollideBatch(ColliderSet.Spaces[EllipsoidIndex], ColliderSet.Radii[EllipsoidIndex],
+					MakeArrayView(WorkData.Starts).Slice(LevelStart, LevelSize),
+					MakeArrayView(WorkData.Ends).Slice(LevelStart, LevelSize),
+					MakeArrayView(WorkData.Directions).Slice(LevelStart, LevelSize), Adapt);
+			}
+		}
+
+		for (int32 Slot = LevelStart; Slot < LevelStart + LevelSize; Slot++)
+		{
+			const FVector& Start = WorkData.Starts[Slot];
+			if (!WorkData.Tips[Slot].Equals(WorkData.Ends[Slot]))
+			{
+				const FQuat Rotation = FQuat::FindBetweenVectors(WorkData.Tips[Slot] - Start, WorkData.Ends[Slot] - Start);
+				WorkData.Solved[Slot].SetRotation(Rotation * WorkData.Solved[Slot].GetRotation());
+			}
+
+			if (Debug)
+			{
+				Debug->AddLine(Start, WorkData.Ends[Slot], DebugSettings.Scale * 0.1f, FLinearColor::White);
+				Debug->AddPoint(WorkData.Ends[Slot], DebugSettings.Scale * 5.0f, FLinearColor::White);
+			}
+		}
+	}
+
+	// Every pivot and connector is set explicitly, then each branch is propagated exactly once
+	for (int32 Slot = 0; Slot < SlotNum; Slot++)
+	{
+		FRigTracedWrite::SetGlobalTransform(Hierarchy, WorkData.PivotCaches[WorkData.Order[Slot]], WorkData.Solved[Slot], false, false);
+	}
+
+	for (int32 Index = 0; Index < ConnectorNum; Index++)
+	{
+		FRigTracedWrite::SetGlobalTransform(Hierarchy, WorkData.Connectors[Index], WorkData.ConnectorTransforms[Index] * WorkData.Solved[WorkData.ConnectorParents[Index]], false, false);
+	}
+
+	for (int32 Index = 0; Index < BranchNum; Index++)
+	{
+		FRigTracedWrite::SetLocalTransform(Hierarchy, WorkData.Branches[Index], WorkData.BranchLocals[Index], false, true);
+	}
+
+	if (Debug)
+	{
+		Debug->Flush(ExecuteContext.GetDrawInterface());
+	}
+
+	ANGRY_RIGUNIT_TRACE_COUNT(ChainLength, SlotNum);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void FRigUnit_EllipsoidChainCollide_WorkData::Project(EEllipsoidProjectionMode Mode, int32 Iterations, const FVector& Point, FVector& Closest, FVector& Normal)
+{
+	// Lower bound for the distance to each ellipsoid surface
+	CandidateBounds.Reset();
+	for (const int32 Candidate : Candidates)
+	{
+		CandidateBounds.Emplace((Point - BoundCenters[Candidate]).Size() - BoundRadii[Candidate], Candidate);
+	}
+	CandidateBounds.Sort([](const TPair<float, int32>& A, const TPair<float, int32>& B) { return A.Key < B.Key; });
+
+	float BestDistance = TNumericLimits<float>::Max();
+	for (const TPair<float, int32>& Bound : CandidateBounds)
+	{
+		if (Bound.Key >= BestDistance)
+		{
+			break;
+		}
+
+		FVector CurrClosest, CurrNormal;
+		FRigUnit_EllipsoidProjection::ComputeEllispoidProjection(Mode, Iterations, Spaces[Bound.Value], Radii[Bound.Value], Point, CurrClosest, CurrNormal);
+
+		const float CurrDistance = (Point - CurrClosest).Size();
+		if (CurrDistance < BestDistance)
+		{
+			BestDistance = CurrDistance;
+			Closest = CurrClosest;
+			Normal = CurrNormal;
+		}
+	}
+}
+
+bool FRigUnit_EllipsoidChainCollide_WorkData::Sweep(int32 Segment, const FVector& Point, FVector& Impact, FVector& Normal) const
+{
+	float BestTime = 1.0f;
+	int32 BestCandidate = INDEX_NONE;
+	FVector BestLocal = FVector::ZeroVector;
+	for (const int32 Candidate : Candidates)
+	{
+		// Ellipsoids that just became valid have no history to sweep from
+		if (!PreviousValid[Candidate])
+		{
+			continue;
+		}
+
+		// Move linearly in ellipsoid space from last frame's location relative to the ellipsoid to the current one
+		const FVector From = PreviousSpaces[Candidate].InverseTransformPosition(PreviousPoints[Segment]);
+		const FVector To = Spaces[Candidate].InverseTransformPosition(Point);
+		const FVector Delta = To - From;
+
+		// Points that already started inside are handled by the projection
+		const float C = From.SizeSquared() - FMath::Square(Radii[Candidate]);
+		const float A = Delta.SizeSquared();
+		if (C <= 0.0f || FMath::IsNearlyZero(A))
+		{
+			continue;
+		}
+
+		const float B = 2.0f * (From | Delta);
+		const float Discr = B * B - 4.0f * A * C;
+		if (Discr < 0.0f)
+		{
+			continue;
+		}
+
+		const float Time = (-B - FMath::Sqrt(Discr)) / (2.0f * A);
+		if (Time >= 0.0f && Time <= BestTime)
+		{
+			BestTime = Time;
+			BestCandidate = Candidate;
+			BestLocal = From + Delta * Time;
+		}
+	}
+
+	if (BestCandidate == INDEX_NONE)
+	{
+		return false;
+	}
+
+	// Respond on the side the point entered from, in the current pose of the ellipsoid
+	const FEllipsoidSpace& Current = Spaces[BestCandidate];
+	Impact = Current.TransformPosition(BestLocal);
+	Normal = Current.TransformNormal(BestLocal).GetSafeNormal();
+	return true;
+}
+
 FRigUnit_EllipsoidChainCollide_Execute()
 {
 	DECLARE_SCOPE_HIERARCHICAL_COUNTER_RIGUNIT();
+	ANGRY_RIGUNIT_TRACE_SCOPE(EllipsoidChainCollide);
 	URigHierarchy* Hierarchy = ExecuteContext.Hierarchy;
-	FRigVMDrawInterface* DrawInterface = ExecuteContext.GetDrawInterface();
+
+	if (!Hierarchy)
+	{
+		return;
+	}
 
 	const int32 ChainNum = Chain.Num();
 	if (ChainNum < 2)
 	{
 		UE_CONTROLRIG_RIGUNIT_REPORT_WARNING(TEXT("Chain has to have length at least 2."));
 	}
-	else if (!EllipsoidCache.UpdateCache(Ellipsoid.Key, Hierarchy))
+	else if (!ChainCache.Update(Chain, Hierarchy))
 	{
-		UE_CONTROLRIG_RIGUNIT_REPORT_WARNING(TEXT("key '%s' is not valid."), *Ellipsoid.Key.ToString());
+		UE_CONTROLRIG_RIGUNIT_REPORT_WARNING(TEXT("Chain contains invalid elements."));
 	}
 	else
 	{
+		TArray<FCachedRigElement>& CachedChain = ChainCache.CachedChain;
+		TArray<FTransform>& Transforms = ChainCache.WriteBack.Transforms;
+
+		// Only record debug primitives if enabled
+		FRigDebugBuffer* Debug = DebugSettings.IsEnabled() ? &ChainCache.DebugBuffer : nullptr;
+
 		// Apply rotation along the whole chain
-		FTransform Transform = Hierarchy->GetGlobalTransform(Chain[0]);
-		const FTransform EllipsoidTransform = Hierarchy->GetGlobalTransform(EllipsoidCache);
+		FTransform Transform = Hierarchy->GetGlobalTransform(CachedChain[0]);
 
 		const float MaxChainLength = FRigUnit_ChainAnalysis::ComputeInitialChainLength(Chain, Hierarchy);
+		const float Reach = (1.0f + DiscoveryRatio) * MaxChainLength;
 
-		// Intensity according to relative distance
-		FVector Anchor, AnchorNormal;
-		FRigUnit_EllipsoidProjection::ComputeEllispoidProjection(EllipsoidTransform, Ellipsoid.Radius, Transform.GetLocation(), Anchor, AnchorNormal);
+		// Broadphase, only ellipsoids whose bounding sphere is in reach of the chain root can affect the chain
+		// Prepared ellipsoids already have their transforms and bounds resolved
+		const bool bUseColliderSet = ColliderSet.Num() > 0;
 
-		// Diminish intensity with distance 
-		const float Distance = (Transform.GetLocation() - Anchor).Size();// | AnchorNormal;
-		const float Intensity = FMath::Clamp(1.0f + DiscoveryRatio - Distance / MaxChainLength, 0.0f, 1.0f);
+		// Rigs saved with the single ellipsoid pin keep colliding with it as the last entry
+		const bool bDeprecatedEllipsoid = Ellipsoid.Key.IsValid();
+		const int32 EllipsoidNum = bUseColliderSet ? ColliderSet.Num() : Ellipsoids.Num() + (bDeprecatedEllipsoid ? 1 : 0);
+		if (bUseColliderSet)
+		{
+			WorkData.Spaces = ColliderSet.Spaces;
+			WorkData.Radii = ColliderSet.Radii;
+			WorkData.BoundCenters = ColliderSet.BoundCenters;
+			WorkData.BoundRadii = ColliderSet.BoundRadii;
+		}
+		else
+		{
+			WorkData.EllipsoidCaches.SetNum(EllipsoidNum);
+			WorkData.Spaces.SetNum(EllipsoidNum, false);
+			WorkData.Radii.SetNumUninitialized(EllipsoidNum, false);
+			WorkData.BoundCenters.SetNumUninitialized(EllipsoidNum, false);
+			WorkData.BoundRadii.SetNumUninitialized(EllipsoidNum, false);
+		}
+		WorkData.Valid.Init(false, EllipsoidNum);
+		WorkData.Candidates.Reset();
+
+		float Distance = TNumericLimits<float>::Max();
+		for (int32 EllipsoidIndex = 0; EllipsoidIndex < EllipsoidNum; EllipsoidIndex++)
+		{
+			if (bUseColliderSet)
+			{
+				if (!ColliderSet.IsValidIndex(EllipsoidIndex))
+				{
+					continue;
+				}
+			}
+			else
+			{
+				const FEllipsoid& Collider = Ellipsoids.IsValidIndex(EllipsoidIndex) ? Ellipsoids[EllipsoidIndex] : Ellipsoid;
+				if (!WorkData.EllipsoidCaches[EllipsoidIndex].UpdateCache(Collider.Key, Hierarchy))
+				{
+					UE_CONTROLRIG_RIGUNIT_REPORT_WARNING(TEXT("key '%s' is not valid."), *Collider.Key.ToString());
+					continue;
+				}
+
+				// Same scale clamping as prepared ellipsoids so projection and sweep see the same shape
+				const FTransform EllipsoidTransform = ClampEllipsoidScale(Hierarchy->GetGlobalTransform(WorkData.EllipsoidCaches[EllipsoidIndex]));
+				WorkData.Spaces[EllipsoidIndex] = FEllipsoidSpace(EllipsoidTransform);
+				WorkData.Radii[EllipsoidIndex] = Collider.Radius;
+				WorkData.BoundCenters[EllipsoidIndex] = EllipsoidTransform.GetLocation();
+				WorkData.BoundRadii[EllipsoidIndex] = Collider.Radius * EllipsoidTransform.GetScale3D().GetAbsMax();
+			}
+			WorkData.Valid[EllipsoidIndex] = true;
+
+			if ((Transform.GetLocation() - WorkData.BoundCenters[EllipsoidIndex]).Size() - WorkData.BoundRadii[EllipsoidIndex] < Reach)
+			{
+				WorkData.Candidates.Emplace(EllipsoidIndex);
+
+				// Intensity according to relative distance
+				FVector Anchor, AnchorNormal;
+				FRigUnit_EllipsoidProjection::ComputeEllispoidProjection(ProjectionMode, Iterations, WorkData.Spaces[EllipsoidIndex], WorkData.Radii[EllipsoidIndex], Transform.GetLocation(), Anchor, AnchorNormal);
+				Distance = FMath::Min(Distance, (Transform.GetLocation() - Anchor).Size());
+			}
+		}
+
+		// Diminish intensity with distance to the closest ellipsoid
+		const float Intensity = WorkData.Candidates.IsEmpty() ? 0.0f : FMath::Clamp(1.0f + DiscoveryRatio - Distance / MaxChainLength, 0.0f, 1.0f);
+
+		// Previous frame is only usable if nothing was added or removed since
+		const bool bSweep = bSwept && WorkData.PreviousPoints.Num() == ChainNum - 1 && WorkData.PreviousSpaces.Num() == EllipsoidNum && WorkData.PreviousValid.Num() == EllipsoidNum;
+		WorkData.PreviousPoints.SetNumUninitialized(ChainNum - 1, false);
 
 		// Rotate each segment
 		const float MaxRadians = FMath::DegreesToRadians(MaxAngle);
@@ -498,7 +1547,7 @@ FRigUnit_EllipsoidChainCollide_Execute()
 
 		for (int32 Index = 1; Index < ChainNum; Index++)
 		{
-			const FTransform Local = Hierarchy->GetLocalTransform(Chain[Index]);
+			const FTransform Local = ChainCache.WriteBack.GetLocalTransform(Hierarchy, Index);
 
 			// Collide future bone location with ellipsoid
 			const FVector Start = Transform.GetLocation();
@@ -510,7 +1559,10 @@ FRigUnit_EllipsoidChainCollide_Execute()
 			{
 				FVector Closest, Normal;
 				const FVector Point = Start + Delta * CollisionPointRatio;
-				FRigUnit_EllipsoidProjection::ComputeEllispoidProjection(EllipsoidTransform, Ellipsoid.Radius, Point, Closest, Normal);
+				if (!bSweep || !WorkData.Sweep(Index - 1, Point, Closest, Normal))
+				{
+					WorkData.Project(ProjectionMode, Iterations, Point, Closest, Normal);
+				}
 
 				const FVector FinalPlane = FVector::VectorPlaneProject(FVector::VectorPlaneProject(DeltaNormal, Normal), WorldAxis);
 				const FVector FinalDelta = FMath::Lerp(DeltaNormal, FinalPlane, Intensity).GetSafeNormal() * DeltaSize;
@@ -523,32 +1575,51 @@ FRigUnit_EllipsoidChainCollide_Execute()
 				Transform.SetRotation(FinalRotation * Transform.GetRotation());
 
 				// Update chain element
-				Hierarchy->SetGlobalTransform(Chain[Index - 1], Transform, false, PropagateToChildren == EPropagation::All);
+				Transforms[Index - 1] = Transform;
 
 				// Propagate
 				Transform = Local * Transform;
 
-				if (DebugSettings.bEnabled)
+				if (Debug)
 				{
-					DrawInterface->DrawPoint(FTransform::Identity, Point, DebugSettings.Scale * 2.0f, FLinearColor::White);
-					DrawInterface->DrawPoint(FTransform::Identity, Closest, DebugSettings.Scale * 2.0f, FLinearColor::Black);
+					Debug->AddPoint(Point, DebugSettings.Scale * 2.0f, FLinearColor::White);
+					Debug->AddPoint(Closest, DebugSettings.Scale * 2.0f, FLinearColor::Black);
 				}
 			}
 			else
 			{
-				FRigUnit_BendTowards::BendTowards(Chain[Index - 1], Chain[Index], Start + Delta, Hierarchy, ScaleType, PropagateToChildren == EPropagation::All);
-				Transform = Hierarchy->GetGlobalTransform(Chain[Index]);
+				FTransform Next;
+				Transforms[Index - 1] = FRigUnit_BendTowards::BendTransform(Transform, Local, Start + Delta, ScaleType, 1.0f, Next);
+				Transform = Next;
 			}
 
+			WorkData.PreviousPoints[Index - 1] = FMath::Lerp(Start, Transform.GetLocation(), CollisionPointRatio);
 
-			if (DebugSettings.bEnabled)
+			if (Debug)
 			{
-				DrawInterface->DrawLine(FTransform::Identity, Start - WorldAxis * 5.0f, Start + WorldAxis * 5.0f, FLinearColor::Red, DebugSettings.Scale * 0.1f);
-				DrawInterface->DrawPoint(FTransform::Identity, Start, DebugSettings.Scale * 5.0f, FLinearColor::Blue);
+				Debug->AddLine(Start - WorldAxis * 5.0f, Start + WorldAxis * 5.0f, DebugSettings.Scale * 0.1f, FLinearColor::Red);
+				Debug->AddPoint(Start, DebugSettings.Scale * 5.0f, FLinearColor::Blue);
 			}
 		}
 
-		Hierarchy->SetGlobalTransform(Chain.Last(), Transform, false, PropagateToChildren != EPropagation::Off);
+		Transforms.Last() = Transform;
+		ChainCache.WriteBack.Commit(Hierarchy, PropagateToChildren);
+
+		if (bSwept)
+		{
+			WorkData.PreviousSpaces = WorkData.Spaces;
+			WorkData.PreviousValid = WorkData.Valid;
+		}
+		else
+		{
+			WorkData.PreviousSpaces.Reset();
+			WorkData.PreviousValid.Reset();
+		}
+
+		if (Debug)
+		{
+			Debug->Flush(ExecuteContext.GetDrawInterface());
+		}
 	}
 }
 
@@ -557,17 +1628,20 @@ FRigUnit_EllipsoidChainCollide_Execute()
 FRigUnit_EllipsoidTransformProject_Execute()
 {
 	DECLARE_SCOPE_HIERARCHICAL_COUNTER_RIGUNIT();
+	ANGRY_RIGUNIT_TRACE_SCOPE(EllipsoidTransformProject);
 	const URigHierarchy* Hierarchy = ExecuteContext.Hierarchy;
-	FRigVMDrawInterface* DrawInterface = ExecuteContext.GetDrawInterface();
+	FRigVMDrawInterface* DrawInterface = DebugSettings.IsEnabled() ? ExecuteContext.GetDrawInterface() : nullptr;
 
 	if (!Hierarchy)
 	{
 		return;
 	}
 
-	if (!EllipsoidCache.UpdateCache(Ellipsoid.Key, Hierarchy))
+	FEllipsoidSpace Space;
+	float Radius;
+	if (!ResolveEllipsoid(Hierarchy, Ellipsoid, EllipsoidCache, ColliderSet, ColliderIndex, Space, Radius))
 	{
-		UE_CONTROLRIG_RIGUNIT_REPORT_WARNING(TEXT("key '%s' is not valid."), *Ellipsoid.Key.ToString());
+		UE_CONTROLRIG_RIGUNIT_REPORT_WARNING(TEXT("%s is not valid."), *DescribeEllipsoid(Ellipsoid, ColliderIndex));
 	}
 	else
 	{
@@ -578,30 +1652,29 @@ FRigUnit_EllipsoidTransformProject_Execute()
 
 		const FVector EELocation = EndEETarget.GetLocation();
 
-		const FTransform EllipsoidTransform = Hierarchy->GetGlobalTransform(EllipsoidCache);
 		const FVector RayStart = EELocation + EEUpTarget * Discovery;
 
 		// Get closest point on the ellipsoid to the ray
 		float HitDistance;
 		FVector Closest, Normal;
-		FRigUnit_EllipsoidRaycast::ComputeEllispoidRaycast(EllipsoidTransform, Ellipsoid.Radius, RayStart, EELocation, Closest, Normal, HitDistance);
+		FRigUnit_EllipsoidRaycast::ComputeEllispoidRaycast(Space, Radius, RayStart, EELocation, Closest, Normal, HitDistance);
 		if (!FMath::IsNearlyZero(HitDistance))
 		{
 			const FVector RayDelta = EELocation - RayStart;
 			const float RayLength = RayDelta.Size();
 			const FVector RayNormal = RayDelta / RayLength;
 			const FVector Point = RayStart + RayNormal * FMath::Clamp((Closest - RayStart) | RayNormal, 0.0f, RayLength);
-			FRigUnit_EllipsoidProjection::ComputeEllispoidProjection(EllipsoidTransform, Ellipsoid.Radius, Point, Closest, Normal);
+			FRigUnit_EllipsoidProjection::ComputeEllispoidProjection(Space, Radius, Point, Closest, Normal);
 
 			HitDistance = (Point - Closest).Size();
 
-			if (DebugSettings.bEnabled)
+			if (DebugSettings.IsEnabled())
 			{
 				DrawInterface->DrawPoint(FTransform::Identity, Point, DebugSettings.Scale * 5.0f, FLinearColor::Blue);
 			}
 		}
 
-		if (DebugSettings.bEnabled)
+		if (DebugSettings.IsEnabled())
 		{
 			DrawInterface->DrawLine(FTransform::Identity, RayStart, EELocation, FLinearColor::White, DebugSettings.Scale * 0.1f);
 			DrawInterface->DrawLine(FTransform::Identity, Closest, Closest + Normal * 10.0f, FLinearColor::Green, DebugSettings.Scale * 0.1f);
@@ -621,7 +1694,7 @@ FRigUnit_EllipsoidTransformProject_Execute()
 		Projection.SetLocation(LocationTarget);
 		Projection.SetScale3D(Objective.GetScale3D());
 
-		if (DebugSettings.bEnabled)
+		if (DebugSettings.IsEnabled())
 		{
 			DrawInterface->DrawPoint(FTransform::Identity, LocationTarget, DebugSettings.Scale * 5.0f, FLinearColor::Red);
 		}
@@ -10,8 +10,9 @@
 FRigUnit_EyeLookAt_Execute()
 {
 	DECLARE_SCOPE_HIERARCHICAL_COUNTER_RIGUNIT();
+	ANGRY_RIGUNIT_TRACE_SCOPE(EyeLookAt);
 	URigHierarchy* Hierarchy = ExecuteContext.Hierarchy;
-	FRigVMDrawInterface* DrawInterface = ExecuteContext.GetDrawInterface();
+	FRigVMDrawInterface* DrawInterface = DebugSettings.IsEnabled() ? ExecuteContext.GetDrawInterface() : nullptr;
 
 	if (!Hierarchy)
 	{
@@ -32,7 +33,7 @@ FRigUnit_EyeLookAt_Execute()
 		const FVector CurrentRight = -Transform.GetUnitAxis(EAxis::X);
 		const FVector CurrentUp = Transform.GetUnitAxis(EAxis::Z);
 
-		if (DebugSettings.bEnabled)
+		if (DebugSettings.IsEnabled())
 		{
 			DrawInterface->DrawLine(FTransform::Identity, Transform.GetLocation(), Transform.GetLocation() + CurrentForward * 10.0f, FLinearColor::Red, DebugSettings.Scale * 0.1f);
 			DrawInterface->DrawLine(FTransform::Identity, Transform.GetLocation(), Transform.GetLocation() + CurrentRight * 10.0f, FLinearColor::Green, DebugSettings.Scale * 0.1f);
@@ -64,9 +65,9 @@ FRigUnit_EyeLookAt_Execute()
 
 		Transform.SetRotation(Between * Transform.GetRotation() * OffsetRotation.Quaternion());
 
-		Hierarchy->SetGlobalTransform(Cache, Transform, bPropagateToChildren);
+		FRigTracedWrite::SetGlobalTransform(Hierarchy, Cache, Transform, bPropagateToChildren, true);
 
-		if (DebugSettings.bEnabled)
+		if (DebugSettings.IsEnabled())
 		{
 			DrawInterface->DrawLine(FTransform::Identity, Transform.GetLocation(), Transform.GetLocation() + FinalDirection * 15.0f, FLinearColor::White, DebugSettings.Scale * 0.5f);
 			DrawInterface->DrawLine(FTransform::Identity, Transform.GetLocation(), Transform.GetLocation() + TargetDirection * 20.0f, FLinearColor::Black, DebugSettings.Scale * 0.25f);
@@ -81,8 +82,9 @@ FRigUnit_EyeLookAt_Execute()
 FRigUnit_EyelidDisplacement_Execute()
 {
 	DECLARE_SCOPE_HIERARCHICAL_COUNTER_RIGUNIT();
+	ANGRY_RIGUNIT_TRACE_SCOPE(EyelidDisplacement);
 	URigHierarchy* Hierarchy = ExecuteContext.Hierarchy;
-	FRigVMDrawInterface* DrawInterface = ExecuteContext.GetDrawInterface();
+	FRigVMDrawInterface* DrawInterface = DebugSettings.IsEnabled() ? ExecuteContext.GetDrawInterface() : nullptr;
 
 	if (!Cache.UpdateCache(Key, Hierarchy))
 	{
@@ -101,7 +103,7 @@ FRigUnit_EyelidDisplacement_Execute()
 		const FVector CurrentRight = -Transform.GetUnitAxis(EAxis::X);
 		const FVector CurrentUp = Transform.GetUnitAxis(EAxis::Z);
 
-		if (DebugSettings.bEnabled)
+		if (DebugSettings.IsEnabled())
 		{
 			DrawInterface->DrawLine(FTransform::Identity, Transform.GetLocation(), Transform.GetLocation() + CurrentForward * 10.0f, FLinearColor::Red, DebugSettings.Scale * 0.1f);
 			DrawInterface->DrawLine(FTransform::Identity, Transform.GetLocation(), Transform.GetLocation() + CurrentRight * 10.0f, FLinearColor::Green, DebugSettings.Scale * 0.1f);
@@ -124,9 +126,9 @@ FRigUnit_EyelidDisplacement_Execute()
 
 		Transform.SetRotation(LidRotation * Transform.GetRotation() * OffsetRotation.Quaternion());
 
-		Hierarchy->SetGlobalTransform(Cache, Transform, bPropagateToChildren);
+		FRigTracedWrite::SetGlobalTransform(Hierarchy, Cache, Transform, bPropagateToChildren, true);
 
-		if (DebugSettings.bEnabled)
+		if (DebugSettings.IsEnabled())
 		{
 			DrawInterface->DrawLine(FTransform::Identity, Transform.GetLocation(), Transform.GetLocation() + CenterRotation * CurrentUp * 15.0f, FLinearColor::White, DebugSettings.Scale * 0.5f);
 		}
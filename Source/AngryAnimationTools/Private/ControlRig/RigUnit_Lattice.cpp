@@ -3,12 +3,13 @@
 #pragma once
 
 #include "ControlRig/RigUnit_Lattice.h"
+#include "ControlRig/RigUnit_BendTowards.h"
 
 FRigUnit_LatticeTransform_Execute()
 {
 	DECLARE_SCOPE_HIERARCHICAL_COUNTER_RIGUNIT();
+	ANGRY_RIGUNIT_TRACE_SCOPE(LatticeTransform);
 	URigHierarchy* Hierarchy = ExecuteContext.Hierarchy;
-	FRigVMDrawInterface* DrawInterface = ExecuteContext.GetDrawInterface();
 
 	if (!Hierarchy)
 	{
@@ -23,29 +24,87 @@ FRigUnit_LatticeTransform_Execute()
 		return;
 	}
 
-	if (WorkData.Weights.Num() != ChainNum)
+	WorkData.CachedChain.SetNum(ChainNum);
+	for (int32 ChainIndex = 0; ChainIndex < ChainNum; ChainIndex++)
+	{
+		if (!WorkData.CachedChain[ChainIndex].UpdateCache(Chain[ChainIndex], Hierarchy))
+		{
+			UE_CONTROLRIG_RIGUNIT_REPORT_WARNING(TEXT("key '%s' is not valid."), *Chain[ChainIndex].ToString());
+			return;
+		}
+	}
+	WorkData.WriteBack.Prepare(WorkData.CachedChain, Hierarchy);
+
+	WorkData.CachedLattice.SetNum(LatticeNum);
+	WorkData.LatticeTransforms.SetNumUninitialized(LatticeNum, false);
+	for (int32 LatticeIndex = 0; LatticeIndex < LatticeNum; LatticeIndex++)
 	{
-		WorkData.Weights.SetNumZeroed(ChainNum);
+		if (!WorkData.CachedLattice[LatticeIndex].UpdateCache(Lattice[LatticeIndex].Key, Hierarchy))
+		{
+			UE_CONTROLRIG_RIGUNIT_REPORT_WARNING(TEXT("key '%s' is not valid."), *Lattice[LatticeIndex].Key.ToString());
+			return;
+		}
+		WorkData.LatticeTransforms[LatticeIndex] = Hierarchy->GetGlobalTransform(WorkData.CachedLattice[LatticeIndex], false);
+	}
+
+	// Weights and parents refer to lattice elements by position, rebuild them if any of these moved
+	bool bLatticeChanged = WorkData.LatticeElements.Num() != LatticeNum;
+	WorkData.LatticeElements.SetNum(LatticeNum);
+	for (int32 LatticeIndex = 0; LatticeIndex < LatticeNum; LatticeIndex++)
+	{
+		const int32 LatticeElement = WorkData.CachedLattice[LatticeIndex].GetIndex();
+		bLatticeChanged |= WorkData.LatticeElements[LatticeIndex] != LatticeElement;
+		WorkData.LatticeElements[LatticeIndex] = LatticeElement;
+	}
+
+	if (bLatticeChanged || WorkData.WeightOffsets.Num() != ChainNum + 1 || WorkData.WeightThreshold != WeightThreshold || WorkData.MaxInfluences != MaxInfluences)
+	{
+		WorkData.WeightThreshold = WeightThreshold;
+		WorkData.MaxInfluences = MaxInfluences;
+
+		WorkData.WeightOffsets.SetNumUninitialized(ChainNum + 1);
+		WorkData.WeightIndices.Reset();
+		WorkData.WeightValues.Reset();
+
+		TArray<TPair<float, int32>> Row;
+		Row.Reserve(LatticeNum);
 		for (int32 ChainIndex = 0; ChainIndex < ChainNum; ChainIndex++)
 		{
-			const FTransform ChainTransform = Hierarchy->GetGlobalTransform(Chain[ChainIndex]);
+			const FTransform ChainTransform = Hierarchy->GetGlobalTransform(WorkData.CachedChain[ChainIndex]);
 
-			TArray<float>& Weights = WorkData.Weights[ChainIndex];
-			Weights.SetNumZeroed(LatticeNum);
+			Row.Reset();
 			for (int32 LatticeIndex = 0; LatticeIndex < LatticeNum; LatticeIndex++)
 			{
-				const FTransform LatticeTransform = Hierarchy->GetGlobalTransform(Lattice[LatticeIndex].Key);
+				const FTransform& LatticeTransform = WorkData.LatticeTransforms[LatticeIndex];
 
 				const FVector X = LatticeTransform.InverseTransformPosition(ChainTransform.GetLocation());
 				const FVector D = X / Lattice[LatticeIndex].Distribution.ComponentMax(FVector(1.));
 
 				const float Weight = static_cast<float>(FMath::Exp(D.SizeSquared() * -1.));
-				Weights[LatticeIndex] = Weight;
+				if (Weight >= WeightThreshold)
+				{
+					Row.Emplace(FMath::Min(Weight, 1.f), LatticeIndex);
+				}
+			}
+
+			// Only keep the strongest influences
+			if (MaxInfluences > 0 && Row.Num() > MaxInfluences)
+			{
+				Row.Sort([](const TPair<float, int32>& A, const TPair<float, int32>& B) { return A.Key > B.Key; });
+				Row.SetNum(MaxInfluences, false);
+			}
+
+			WorkData.WeightOffsets[ChainIndex] = WorkData.WeightIndices.Num();
+			for (const TPair<float, int32>& Influence : Row)
+			{
+				WorkData.WeightValues.Emplace(Influence.Key);
+				WorkData.WeightIndices.Emplace(Influence.Value);
 			}
 		}
+		WorkData.WeightOffsets[ChainNum] = WorkData.WeightIndices.Num();
 	}
 
-	if (WorkData.CachedParents.Num() != LatticeNum)
+	if (bLatticeChanged || WorkData.CachedParents.Num() != LatticeNum)
 	{
 		WorkData.CachedParents.SetNumZeroed(LatticeNum);
 		for (int32 LatticeIndex = 0; LatticeIndex < LatticeNum; LatticeIndex++)
@@ -61,13 +120,18 @@ FRigUnit_LatticeTransform_Execute()
 		}
 	}
 
-	TArray<FTransform> LatticeDeltaTransforms;
-	LatticeDeltaTransforms.SetNumUninitialized(LatticeNum);
+	// Only record debug primitives if enabled
+	FRigDebugBuffer* Debug = DebugSettings.IsEnabled() ? &WorkData.DebugBuffer : nullptr;
+
+	TArray<FTransform>& LatticeDeltaTransforms = WorkData.LatticeDeltaTransforms;
+	LatticeDeltaTransforms.SetNumUninitialized(LatticeNum, false);
 	for (int32 LatticeIndex = 0; LatticeIndex < LatticeNum; LatticeIndex++)
 	{
-		const FTransform CurrentLatticeTransform = Hierarchy->GetLocalTransform(Lattice[LatticeIndex].Key, false);
-		const FTransform InitialLatticeTransform = Hierarchy->GetLocalTransform(Lattice[LatticeIndex].Key, true);
-		const FTransform ParentLatticeTransform = Hierarchy->GetGlobalTransform(WorkData.CachedParents[LatticeIndex].GetKey(), false);
+		const int32 LatticeElement = WorkData.CachedLattice[LatticeIndex].GetIndex();
+		const FTransform CurrentLatticeTransform = Hierarchy->GetLocalTransform(LatticeElement, false);
+		const FTransform InitialLatticeTransform = Hierarchy->GetLocalTransform(LatticeElement, true);
+		const FCachedRigElement& CachedParent = WorkData.CachedParents[LatticeIndex];
+		const FTransform ParentLatticeTransform = CachedParent.IsValid() ? Hierarchy->GetGlobalTransform(CachedParent.GetIndex(), false) : FTransform::Identity;
 
 		const FTransform CurrentTransform = CurrentLatticeTransform * ParentLatticeTransform;
 		const FTransform InitialTransform = InitialLatticeTransform * ParentLatticeTransform;
@@ -77,31 +141,30 @@ FRigUnit_LatticeTransform_Execute()
 			CurrentTransform.GetLocation() - InitialTransform.GetLocation(),
 			CurrentTransform.GetScale3D() / InitialTransform.GetScale3D());
 
-		if (DebugSettings.bEnabled)
+		if (Debug)
 		{
 			const FVector Lm = Lattice[LatticeIndex].Distribution.ComponentMax(FVector(1.));
-			DrawInterface->DrawLine(CurrentTransform, FVector(-Lm.X, 0., 0.), FVector(Lm.X, 0., 0.), FLinearColor::Red, DebugSettings.Scale * 0.5f);
-			DrawInterface->DrawLine(CurrentTransform, FVector(0., -Lm.Y, 0.), FVector(0., Lm.Y, 0.), FLinearColor::Green, DebugSettings.Scale * 0.5f);
-			DrawInterface->DrawLine(CurrentTransform, FVector(0., 0., -Lm.Z), FVector(0., 0., Lm.Z), FLinearColor::Blue, DebugSettings.Scale * 0.5f);
+			Debug->AddLine(CurrentTransform.TransformPosition(FVector(-Lm.X, 0., 0.)), CurrentTransform.TransformPosition(FVector(Lm.X, 0., 0.)), DebugSettings.Scale * 0.5f, FLinearColor::Red);
+			Debug->AddLine(CurrentTransform.TransformPosition(FVector(0., -Lm.Y, 0.)), CurrentTransform.TransformPosition(FVector(0., Lm.Y, 0.)), DebugSettings.Scale * 0.5f, FLinearColor::Green);
+			Debug->AddLine(CurrentTransform.TransformPosition(FVector(0., 0., -Lm.Z)), CurrentTransform.TransformPosition(FVector(0., 0., Lm.Z)), DebugSettings.Scale * 0.5f, FLinearColor::Blue);
 
-			DrawInterface->DrawPoint(InitialTransform, FVector(0., 0., 0.), DebugSettings.Scale * 1.f, FLinearColor::Yellow);
+			Debug->AddPoint(InitialTransform.GetLocation(), DebugSettings.Scale * 1.f, FLinearColor::Yellow);
 		}
 	}
 
-	TArray<FTransform> Transforms;
-	Transforms.SetNumUninitialized(ChainNum);
+	TArray<FTransform>& Transforms = WorkData.WriteBack.Transforms;
 	for (int32 ChainIndex = 0; ChainIndex < ChainNum; ChainIndex++)
 	{
-		FTransform FieldTransform = Hierarchy->GetGlobalTransform(Chain[ChainIndex]);
-		const TArray<float>& Weights = WorkData.Weights[ChainIndex];
+		FTransform FieldTransform = Hierarchy->GetGlobalTransform(WorkData.CachedChain[ChainIndex]);
 
-		for (int32 LatticeIndex = 0; LatticeIndex < LatticeNum; LatticeIndex++)
+		const int32 WeightEnd = WorkData.WeightOffsets[ChainIndex + 1];
+		for (int32 WeightIndex = WorkData.WeightOffsets[ChainIndex]; WeightIndex < WeightEnd; WeightIndex++)
 		{
-			const float Weight = FMath::Min(Weights[LatticeIndex], 1.f);
-			const FTransform CurrentLatticeTransform = Hierarchy->GetGlobalTransform(Lattice[LatticeIndex].Key, false);
+			const int32 LatticeIndex = WorkData.WeightIndices[WeightIndex];
+			const float Weight = WorkData.WeightValues[WeightIndex];
 
-			const FTransform LatticeDeltaTransform = LatticeDeltaTransforms[LatticeIndex];
-			const FVector Delta = FieldTransform.GetLocation() - CurrentLatticeTransform.GetLocation();
+			const FTransform& LatticeDeltaTransform = LatticeDeltaTransforms[LatticeIndex];
+			const FVector Delta = FieldTransform.GetLocation() - WorkData.LatticeTransforms[LatticeIndex].GetLocation();
 
 			FieldTransform.AddToTranslation((LatticeDeltaTransform.TransformPosition(Delta) - Delta) * Weight);
 			//FTransform::BlendFromIdentityAndAccumulate(FieldTransform, LatticeTransforms[LatticeIndex], ScalarRegister(Weight));
@@ -112,9 +175,34 @@ FRigUnit_LatticeTransform_Execute()
 	}
 
 
-	Hierarchy->SetGlobalTransform(Chain[0], Transforms[0], false, PropagateToChildren);
-	for (int32 ChainIndex = 1; ChainIndex < ChainNum; ChainIndex++)
+	if (WorkData.WriteBack.IsContinuous())
+	{
+		// Bend chain towards field locations in place, each entry is read before it gets overwritten
+		FTransform Transform = Transforms[0];
+		for (int32 ChainIndex = 1; ChainIndex < ChainNum; ChainIndex++)
+		{
+			const FTransform Local = Hierarchy->GetLocalTransform(WorkData.CachedChain[ChainIndex]);
+
+			FTransform Next;
+			Transforms[ChainIndex - 1] = FRigUnit_BendTowards::BendTransform(Transform, Local, Transforms[ChainIndex].GetLocation(), ScaleType, 1.0f, Next);
+			Transform = Next;
+		}
+		Transforms.Last() = Transform;
+
+		WorkData.WriteBack.Commit(Hierarchy, PropagateToChildren ? EPropagation::All : EPropagation::Off);
+	}
+	else
+	{
+		// Chain elements aren't parented to each other (e.g. siblings), bend each one against the live hierarchy
+		FRigTracedWrite::SetGlobalTransform(Hierarchy, WorkData.CachedChain[0], Transforms[0], false, PropagateToChildren);
+		for (int32 ChainIndex = 1; ChainIndex < ChainNum; ChainIndex++)
+		{
+			FRigUnit_BendTowards::BendTowards(WorkData.CachedChain[ChainIndex - 1], WorkData.CachedChain[ChainIndex], Transforms[ChainIndex].GetLocation(), Hierarchy, ScaleType, PropagateToChildren);
+		}
+	}
+
+	if (Debug)
 	{
-		FRigUnit_BendTowards::BendTowards(Chain[ChainIndex-1], Chain[ChainIndex], Transforms[ChainIndex].GetLocation(), Hierarchy, ScaleType, PropagateToChildren);
+		Debug->Flush(ExecuteContext.GetDrawInterface());
 	}
 }
\ No newline at end of file
@@ -5,10 +5,75 @@
 #include "Components/SceneComponent.h"
 #include "Units/RigUnitContext.h"
 #include "ControlRig.h"
+#include "Async/Async.h"
+
+int32 FindPreviewTarget(const URigHierarchy* Hierarchy, const FName& Name)
+{
+	// Controls take priority over bones
+	const int32 ControlIndex = Hierarchy->GetIndex(FRigElementKey(Name, ERigElementType::Control));
+	if (ControlIndex != INDEX_NONE)
+	{
+		return ControlIndex;
+	}
+	return Hierarchy->GetIndex(FRigElementKey(Name, ERigElementType::Bone));
+}
+
+bool NeedsConversionRig(const FRigUnit_PreviewSettings& PreviewSettings, const FRigUnit_PreviewAnimation_WorkData& WorkData)
+{
+	return *PreviewSettings.ConversionRigClass && (!IsValid(WorkData.ConversionRig) || !WorkData.ConversionRig->IsA(PreviewSettings.ConversionRigClass));
+}
+
+UControlRig* CreateConversionRig(UAnimSequence* PreviewAnimation, TSubclassOf<UControlRig> ConversionRigClass)
+{
+	check(IsInGameThread());
+	UControlRig* ConversionRig = NewObject<UControlRig>(PreviewAnimation, ConversionRigClass);
+	ConversionRig->Initialize(true);
+	ConversionRig->RequestInit();
+	return ConversionRig;
+}
+
+// Returns true once the conversion rig is available, UObjects can't safely be created off the game thread
+bool AcquireConversionRig(const FRigUnit_PreviewSettings& PreviewSettings, FRigUnit_PreviewAnimation_WorkData& WorkData)
+{
+	if (IsInGameThread())
+	{
+		WorkData.ConversionRigRequest.Reset();
+		WorkData.ConversionRig = CreateConversionRig(PreviewSettings.PreviewAnimation, PreviewSettings.ConversionRigClass);
+		return true;
+	}
+
+	TSharedPtr<FPreviewConversionRigRequest, ESPMode::ThreadSafe>& Request = WorkData.ConversionRigRequest;
+	if (!Request.IsValid() || Request->ConversionRigClass != PreviewSettings.ConversionRigClass)
+	{
+		Request = MakeShared<FPreviewConversionRigRequest, ESPMode::ThreadSafe>();
+		Request->ConversionRigClass = PreviewSettings.ConversionRigClass;
+
+		// Request keeps the rig alive until this instance picks it up
+		AsyncTask(ENamedThreads::GameThread, [Request, PreviewAnimation = TWeakObjectPtr<UAnimSequence>(PreviewSettings.PreviewAnimation)]()
+		{
+			if (PreviewAnimation.IsValid())
+			{
+				Request->ConversionRig.Reset(CreateConversionRig(PreviewAnimation.Get(), Request->ConversionRigClass));
+			}
+			Request->bDone = true;
+		});
+		return false;
+	}
+
+	if (!Request->bDone)
+	{
+		return false;
+	}
+
+	WorkData.ConversionRig = Request->ConversionRig.Get();
+	Request.Reset();
+	return IsValid(WorkData.ConversionRig);
+}
 
 FRigUnit_PreviewAnimation_Execute()
 {
 	DECLARE_SCOPE_HIERARCHICAL_COUNTER_RIGUNIT();
+	ANGRY_RIGUNIT_TRACE_SCOPE(PreviewAnimation);
 	URigHierarchy* Hierarchy = ExecuteContext.Hierarchy;
 
 	if (!Hierarchy)
@@ -20,18 +85,29 @@ FRigUnit_PreviewAnimation_Execute()
 	{
 		UE_CONTROLRIG_RIGUNIT_REPORT_WARNING(TEXT("No preview animation was supplied"));
 	}
+	else if (!IsValid(PreviewSettings.PreviewAnimation->GetSkeleton()))
+	{
+		UE_CONTROLRIG_RIGUNIT_REPORT_WARNING(TEXT("Preview animation has no skeleton"));
+	}
+	else if (NeedsConversionRig(PreviewSettings, WorkData) && !AcquireConversionRig(PreviewSettings, WorkData))
+	{
+		UE_CONTROLRIG_RIGUNIT_REPORT_WARNING(TEXT("Waiting for the conversion rig to be created on the game thread"));
+	}
 	else
 	{
 		USkeleton* Skeleton = PreviewSettings.PreviewAnimation->GetSkeleton();
 		const FReferenceSkeleton& Reference = Skeleton->GetReferenceSkeleton();
 		const FBoneIndexType BoneNum = Reference.GetNum();
 
-		// TODO: Make this work properly
-		WorkData.bInitialized = false;
-		if (!WorkData.bInitialized)
+		// Only rebuild if any of the inputs changed or a new conversion rig was created
+		if (!WorkData.bInitialized
+			|| WorkData.ConversionRig.Get() != WorkData.CachedConversionRig.Get()
+			|| WorkData.CachedAnimation.Get() != PreviewSettings.PreviewAnimation
+			|| WorkData.CachedSkeleton.Get() != Skeleton
+			|| WorkData.CachedConversionRigClass.Get() != PreviewSettings.ConversionRigClass.Get()
+			|| WorkData.bCachedBake != bBakePose
+			|| WorkData.TopologyVersion != Hierarchy->GetTopologyVersion())
 		{
-			WorkData.ConversionRig.Reset();
-
 			TArray<FBoneIndexType> InRequiredBoneIndexArray;
 			InRequiredBoneIndexArray.Reset(BoneNum);
 			for (FBoneIndexType BoneIndex = 0; BoneIndex < BoneNum; BoneIndex++)
@@ -43,7 +119,6 @@ FRigUnit_PreviewAnimation_Execute()
 			WorkData.BoneContainer = FBoneContainer(InRequiredBoneIndexArray, CurveFilterSettings, *Skeleton);
 			WorkData.Pose.Empty();
 			WorkData.Pose.SetBoneContainer(&WorkData.BoneContainer);
-			WorkData.bInitialized = true;
 
 			WorkData.Curve.InitFrom(WorkData.BoneContainer);
 			WorkData.Attributes = UE::Anim::FStackAttributeContainer();
@@ -52,13 +127,6 @@ FRigUnit_PreviewAnimation_Execute()
 
 			if (*PreviewSettings.ConversionRigClass)
 			{
-				if (!WorkData.ConversionRig.IsValid() || !WorkData.ConversionRig->IsA(PreviewSettings.ConversionRigClass))
-				{
-					WorkData.ConversionRig = NewObject<UControlRig>(PreviewSettings.PreviewAnimation, PreviewSettings.ConversionRigClass);
-					WorkData.ConversionRig->Initialize(true);
-					WorkData.ConversionRig->RequestInit();
-				}
-
 				// register skeletalmesh component
 				// TODO: Reenable by doing something like AcquireSkeletonAndSkelMeshCompFromObject
 				//WorkData.ConversionRig->GetDataSourceRegistry()->RegisterDataSource(UControlRig::OwnerComponent, ExecuteContext.GetOwningComponent());
@@ -67,71 +135,159 @@ FRigUnit_PreviewAnimation_Execute()
 
 				WorkData.ConversionRig->Execute(TEXT("Update"));
 			}
+			else
+			{
+				WorkData.ConversionRig = nullptr;
+			}
 
 			/// //////////////////////
 
-			FAnimationPoseData PoseData(WorkData.Pose, WorkData.Curve, WorkData.Attributes);
-			FAnimExtractContext ExtractContext(WorkData.Time, false);
-			PreviewSettings.PreviewAnimation->GetBonePose(PoseData, ExtractContext);
+			// Resolve where each bone of the animation goes so we don't need any name lookups per frame
+			WorkData.BoneRemap.SetNumUninitialized(BoneNum);
+			WorkData.ControlSources.Reset();
+			WorkData.ControlTargets.Reset();
 
-			if (WorkData.ConversionRig.IsValid())
+			if (IsValid(WorkData.ConversionRig))
 			{
-				URigHierarchy* ConversionBoneHierarchy = WorkData.ConversionRig->GetHierarchy();
-
+				const URigHierarchy* ConversionBoneHierarchy = WorkData.ConversionRig->GetHierarchy();
 				for (FBoneIndexType BoneIndex = 0; BoneIndex < BoneNum; BoneIndex++)
 				{
 					const FName KeyName = Reference.GetBoneName(BoneIndex);
-					const FRigElementKey Key = FRigElementKey(KeyName, ERigElementType::Bone);
-					const FTransform& Transform = WorkData.Pose.GetBones()[BoneIndex];
-					if (ConversionBoneHierarchy->GetIndex(Key) != INDEX_NONE)
+					WorkData.BoneRemap[BoneIndex] = ConversionBoneHierarchy->GetIndex(FRigElementKey(KeyName, ERigElementType::Bone));
+				}
+
+				for (const FRigControlElement* Control : ConversionBoneHierarchy->GetControls())
+				{
+					const int32 Target = FindPreviewTarget(Hierarchy, Control->GetName());
+					if (Target != INDEX_NONE)
 					{
-						ConversionBoneHierarchy->SetLocalTransform(Key, Transform, false, false);
+						WorkData.ControlSources.Emplace(Control->GetIndex());
+						WorkData.ControlTargets.Emplace(Target);
 					}
 				}
+			}
+			else
+			{
+				for (FBoneIndexType BoneIndex = 0; BoneIndex < BoneNum; BoneIndex++)
+				{
+					WorkData.BoneRemap[BoneIndex] = FindPreviewTarget(Hierarchy, Reference.GetBoneName(BoneIndex));
+				}
+			}
 
-				WorkData.ConversionRig->SetDeltaTime(ExecuteContext.GetDeltaTime());
-				WorkData.ConversionRig->Evaluate_AnyThread();
+			/// //////////////////////
+
+			WorkData.BakedFrames = 0;
+			WorkData.BakedTranslations.Empty();
+			WorkData.BakedRotations.Empty();
+			WorkData.BakedScales.Empty();
 
-				const URigHierarchy* ControlHierarchy = WorkData.ConversionRig->GetHierarchy();
-				TArray<FRigControlElement*> Controls = ControlHierarchy->GetControls();
+			if (bBakePose)
+			{
+				// Sample every key once so playback only needs to interpolate
+				const FFrameRate FrameRate = PreviewSettings.PreviewAnimation->GetSamplingFrameRate();
+				const double Duration = PreviewSettings.PreviewAnimation->GetPlayLength();
+				WorkData.BakedFrames = FMath::Max(PreviewSettings.PreviewAnimation->GetNumberOfSampledKeys(), 1);
+				WorkData.BakedInterval = FrameRate.AsInterval();
 
-				const int32 ControlNum = Controls.Num();
-				for (FBoneIndexType ControlIndex = 0; ControlIndex < ControlNum; ControlIndex++)
+				const int32 BakedNum = WorkData.BakedFrames * BoneNum;
+				WorkData.BakedTranslations.SetNumUninitialized(BakedNum);
+				WorkData.BakedRotations.SetNumUninitialized(BakedNum);
+				WorkData.BakedScales.SetNumUninitialized(BakedNum);
+
+				FAnimationPoseData PoseData(WorkData.Pose, WorkData.Curve, WorkData.Attributes);
+				for (int32 Frame = 0; Frame < WorkData.BakedFrames; Frame++)
 				{
-					FRigControlElement* Control = Controls[ControlIndex];
-					const FName KeyName = Control->GetName();
-					const FTransform& Transform = ControlHierarchy->GetGlobalTransform(Control->GetKey());
+					const double FrameTime = FMath::Min(Frame * WorkData.BakedInterval, Duration);
+					FAnimExtractContext ExtractContext(FrameTime, false);
+					PreviewSettings.PreviewAnimation->GetBonePose(PoseData, ExtractContext);
 
-					if (Hierarchy->GetIndex(FRigElementKey(KeyName, ERigElementType::Control)) != INDEX_NONE)
-					{
-						Hierarchy->SetGlobalTransform(FRigElementKey(KeyName, ERigElementType::Control), Transform, false, false);
-					}
-					else if (Hierarchy->GetIndex(FRigElementKey(KeyName, ERigElementType::Bone)) != INDEX_NONE)
+					const TArray<FTransform>& Bones = WorkData.Pose.GetBones();
+					const int32 Offset = Frame * BoneNum;
+					for (FBoneIndexType BoneIndex = 0; BoneIndex < BoneNum; BoneIndex++)
 					{
-						Hierarchy->SetGlobalTransform(FRigElementKey(KeyName, ERigElementType::Bone), Transform, false, false);
+						WorkData.BakedTranslations[Offset + BoneIndex] = Bones[BoneIndex].GetTranslation();
+						WorkData.BakedRotations[Offset + BoneIndex] = Bones[BoneIndex].GetRotation();
+						WorkData.BakedScales[Offset + BoneIndex] = Bones[BoneIndex].GetScale3D();
 					}
 				}
 			}
-			else
+
+			WorkData.CachedAnimation = PreviewSettings.PreviewAnimation;
+			WorkData.CachedSkeleton = Skeleton;
+			WorkData.CachedConversionRigClass = PreviewSettings.ConversionRigClass.Get();
+			WorkData.CachedConversionRig = WorkData.ConversionRig;
+			WorkData.bCachedBake = bBakePose;
+			WorkData.TopologyVersion = Hierarchy->GetTopologyVersion();
+			WorkData.bInitialized = true;
+		}
+
+		BakedMemory = (int32)(WorkData.BakedTranslations.GetAllocatedSize() + WorkData.BakedRotations.GetAllocatedSize() + WorkData.BakedScales.GetAllocatedSize());
+
+		/// //////////////////////
+
+		if (WorkData.BakedFrames > 0)
+		{
+			// Interpolate between the two baked frames around the current time
+			const double FrameTime = WorkData.BakedInterval > 0.0 ? WorkData.Time / WorkData.BakedInterval : 0.0;
+			const int32 Frame = FMath::Clamp(FMath::FloorToInt32(FrameTime), 0, WorkData.BakedFrames - 1);
+			const int32 NextFrame = FMath::Min(Frame + 1, WorkData.BakedFrames - 1);
+			const float Alpha = FMath::Clamp(FrameTime - Frame, 0.0, 1.0);
+
+			TArray<FTransform>& Bones = WorkData.Pose.GetMutableBones();
+			const int32 Offset = Frame * BoneNum;
+			const int32 NextOffset = NextFrame * BoneNum;
+			for (FBoneIndexType BoneIndex = 0; BoneIndex < BoneNum; BoneIndex++)
 			{
-				for (FBoneIndexType BoneIndex = 0; BoneIndex < BoneNum; BoneIndex++)
+				const FQuat Rotation = FQuat::FastLerp(WorkData.BakedRotations[Offset + BoneIndex], WorkData.BakedRotations[NextOffset + BoneIndex], Alpha).GetNormalized();
+				const FVector Translation = FMath::Lerp(WorkData.BakedTranslations[Offset + BoneIndex], WorkData.BakedTranslations[NextOffset + BoneIndex], Alpha);
+				const FVector Scale = FMath::Lerp(WorkData.BakedScales[Offset + BoneIndex], WorkData.BakedScales[NextOffset + BoneIndex], Alpha);
+				Bones[BoneIndex] = FTransform(Rotation, Translation, Scale);
+			}
+		}
+		else
+		{
+			FAnimationPoseData PoseData(WorkData.Pose, WorkData.Curve, WorkData.Attributes);
+			FAnimExtractContext ExtractContext(WorkData.Time, false);
+			PreviewSettings.PreviewAnimation->GetBonePose(PoseData, ExtractContext);
+		}
+
+		const TArray<FTransform>& Bones = WorkData.Pose.GetBones();
+		if (IsValid(WorkData.ConversionRig))
+		{
+			URigHierarchy* ConversionBoneHierarchy = WorkData.ConversionRig->GetHierarchy();
+			for (FBoneIndexType BoneIndex = 0; BoneIndex < BoneNum; BoneIndex++)
+			{
+				const int32 Target = WorkData.BoneRemap[BoneIndex];
+				if (Target != INDEX_NONE)
 				{
-					const FName KeyName = Reference.GetBoneName(BoneIndex);
-					const FTransform& Transform = WorkData.Pose.GetBones()[BoneIndex];
-					if (Hierarchy->GetIndex(FRigElementKey(KeyName, ERigElementType::Control)) != INDEX_NONE)
-					{
-						Hierarchy->SetLocalTransform(FRigElementKey(KeyName, ERigElementType::Control), Transform, false, false);
-					}
-					else if (Hierarchy->GetIndex(FRigElementKey(KeyName, ERigElementType::Bone)) != INDEX_NONE)
-					{
-						Hierarchy->SetLocalTransform(FRigElementKey(KeyName, ERigElementType::Bone), Transform, false, false);
-					}
+					FRigTracedWrite::SetLocalTransform(ConversionBoneHierarchy, Target, Bones[BoneIndex], false, false);
 				}
 			}
 
-			/// //////////////////////
+			WorkData.ConversionRig->SetDeltaTime(ExecuteContext.GetDeltaTime());
+			WorkData.ConversionRig->Evaluate_AnyThread();
+
+			const int32 ControlNum = WorkData.ControlSources.Num();
+			for (int32 ControlIndex = 0; ControlIndex < ControlNum; ControlIndex++)
+			{
+				const FTransform Transform = ConversionBoneHierarchy->GetGlobalTransform(WorkData.ControlSources[ControlIndex]);
+				FRigTracedWrite::SetGlobalTransform(Hierarchy, WorkData.ControlTargets[ControlIndex], Transform, false, false);
+			}
+		}
+		else
+		{
+			for (FBoneIndexType BoneIndex = 0; BoneIndex < BoneNum; BoneIndex++)
+			{
+				const int32 Target = WorkData.BoneRemap[BoneIndex];
+				if (Target != INDEX_NONE)
+				{
+					FRigTracedWrite::SetLocalTransform(Hierarchy, Target, Bones[BoneIndex], false, false);
+				}
+			}
 		}
 
+		/// //////////////////////
+
 		WorkData.Time += ExecuteContext.GetDeltaTime();
 		const float Duration = PreviewSettings.PreviewAnimation->GetPlayLength();
 		if (WorkData.Time > Duration)
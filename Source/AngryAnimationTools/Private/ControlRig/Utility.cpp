@@ -2,4 +2,237 @@
 
 #pragma once
 
-#include "Utility.h"
\ No newline at end of file
+#include "ControlRig/Utility.h"
+#include "Rigs/RigHierarchy.h"
+#include "Units/RigUnitContext.h"
+#include "Components/SkinnedMeshComponent.h"
+
+#if ANGRY_RIGUNIT_TRACE
+
+UE_TRACE_CHANNEL_DEFINE(AngryRigUnitChannel)
+
+UE_TRACE_EVENT_BEGIN(AngryRigUnit, UnitSolve)
+	UE_TRACE_EVENT_FIELD(uint64, StartCycle)
+	UE_TRACE_EVENT_FIELD(uint64, EndCycle)
+	UE_TRACE_EVENT_FIELD(uint32, ThreadId)
+	UE_TRACE_EVENT_FIELD(int32, Iterations)
+	UE_TRACE_EVENT_FIELD(int32, ChainLength)
+	UE_TRACE_EVENT_FIELD(int32, Writes)
+	UE_TRACE_EVENT_FIELD(int32, Propagations)
+	UE_TRACE_EVENT_FIELD(UE::Trace::WideString, Name)
+UE_TRACE_EVENT_END()
+
+static thread_local FRigUnitTraceScope* ActiveRigUnitTraceScope = nullptr;
+
+FRigUnitTraceScope* FRigUnitTraceScope::GetActive()
+{
+	return ActiveRigUnitTraceScope;
+}
+
+void FRigUnitTraceScope::Begin()
+{
+	Previous = ActiveRigUnitTraceScope;
+	ActiveRigUnitTraceScope = this;
+	StartCycle = FPlatformTime::Cycles64();
+}
+
+void FRigUnitTraceScope::End()
+{
+	const uint64 EndCycle = FPlatformTime::Cycles64();
+	ActiveRigUnitTraceScope = Previous;
+
+	UE_TRACE_LOG(AngryRigUnit, UnitSolve, AngryRigUnitChannel)
+		<< UnitSolve.StartCycle(StartCycle)
+		<< UnitSolve.EndCycle(EndCycle)
+		<< UnitSolve.ThreadId(FPlatformTLS::GetCurrentThreadId())
+		<< UnitSolve.Iterations(Iterations)
+		<< UnitSolve.ChainLength(ChainLength)
+		<< UnitSolve.Writes(Writes)
+		<< UnitSolve.Propagations(Propagations)
+		<< UnitSolve.Name(Name);
+}
+
+#endif
+
+int32 FLODSettings::GetLOD(const FControlRigExecuteContext& ExecuteContext) const
+{
+	if (bUseComponentLOD)
+	{
+		if (const USkinnedMeshComponent* Component = Cast<USkinnedMeshComponent>(ExecuteContext.GetOwningComponent()))
+		{
+			return Component->GetPredictedLODLevel();
+		}
+	}
+	return LOD;
+}
+
+ESolverQuality FLODSettings::GetQuality(int32 InLOD) const
+{
+	if (ApproximateLOD >= 0 && InLOD >= ApproximateLOD)
+	{
+		return ESolverQuality::Approximate;
+	}
+
+	if (InLOD >= ReducedLOD)
+	{
+		return ESolverQuality::Reduced;
+	}
+	return ESolverQuality::Full;
+}
+
+int32 FLODSettings::ScaleIterations(int32 Iterations, int32 InLOD) const
+{
+	if (InLOD < ReducedLOD)
+	{
+		return Iterations;
+	}
+
+	const float Scale = FMath::Pow(FMath::Clamp(IterationScale, 0.0f, 1.0f), (float)(InLOD - ReducedLOD + 1));
+	return FMath::Max(FMath::RoundToInt(Iterations * Scale), 1);
+}
+
+void FRigDebugBuffer::Flush(FRigVMDrawInterface* DrawInterface)
+{
+#if ANGRY_RIGUNIT_DEBUG_DRAW
+	if (DrawInterface)
+	{
+		for (const FPoint& Point : Points)
+		{
+			DrawInterface->DrawPoint(FTransform::Identity, Point.Location, Point.Size, Point.Color);
+		}
+
+		for (const FLine& Line : Lines)
+		{
+			DrawInterface->DrawLine(FTransform::Identity, Line.Start, Line.End, Line.Color, Line.Thickness);
+		}
+	}
+	Reset();
+#endif
+}
+
+void FRigChainWriteBack::Prepare(const TArray<FCachedRigElement>& Chain, const URigHierarchy* Hierarchy)
+{
+	const int32 Num = Chain.Num();
+	Transforms.SetNumUninitialized(Num, false);
+
+	bool bChanged = TopologyVersion != Hierarchy->GetTopologyVersion() || Elements.Num() != Num;
+	for (int32 Index = 0; Index < Num && !bChanged; Index++)
+	{
+		bChanged = Elements[Index] != Chain[Index].GetIndex();
+	}
+
+	if (!bChanged)
+	{
+		return;
+	}
+
+	TopologyVersion = Hierarchy->GetTopologyVersion();
+	Elements.SetNumUninitialized(Num);
+	for (int32 Index = 0; Index < Num; Index++)
+	{
+		Elements[Index] = Chain[Index].GetIndex();
+	}
+
+	// Skipped elements in between would get clobbered by restoring branches, siblings wouldn't be moved at all
+	Links.SetNumUninitialized(Num);
+	bContinuous = true;
+	for (int32 Index = 0; Index < Num; Index++)
+	{
+		Links[Index] = Index == 0 || (Elements[Index] != INDEX_NONE && Elements[Index - 1] != INDEX_NONE && Hierarchy->GetFirstParent(Elements[Index]) == Elements[Index - 1]);
+		bContinuous &= Links[Index];
+	}
+
+	// Only the tip propagates directly, every other element needs to know about its branches
+	Branches.Reset();
+	BranchOffsets.SetNumUninitialized(Num);
+	for (int32 Index = 0; Index < Num - 1; Index++)
+	{
+		if (Elements[Index] != INDEX_NONE)
+		{
+			for (const int32 Child : Hierarchy->GetChildren(Elements[Index]))
+			{
+				if (Child != Elements[Index + 1])
+				{
+					Branches.Emplace(Child);
+				}
+			}
+		}
+		BranchOffsets[Index] = Branches.Num();
+	}
+
+	if (Num > 0)
+	{
+		BranchOffsets.Last() = Branches.Num();
+	}
+	BranchLocals.SetNumUninitialized(Branches.Num());
+}
+
+void FRigChainWriteBack::Commit(URigHierarchy* Hierarchy, EPropagation Propagation)
+{
+	const int32 Num = Elements.Num();
+	if (Num == 0)
+	{
+		return;
+	}
+
+	if (!bContinuous)
+	{
+		// Same propagation as writing each element separately, the hierarchy moves whatever is in between
+		for (int32 Index = 0; Index < Num; Index++)
+		{
+			const bool bPropagate = (Index == 0 || Index == Num - 1) ? Propagation != EPropagation::Off : Propagation == EPropagation::All;
+			FRigTracedWrite::SetGlobalTransform(Hierarchy, Elements[Index], Transforms[Index], false, bPropagate);
+		}
+		return;
+	}
+
+	const int32 BranchNum = Propagation != EPropagation::Off ? BranchOffsets.Last() : 0;
+
+	// Branches are sorted from root to tip. With OnlyLast only the root and the tip propagate,
+	// so branches further down the chain follow the root rigidly instead of their own parent
+	const int32 RootBranchNum = Propagation == EPropagation::OnlyLast ? BranchOffsets[0] : BranchNum;
+
+	// Remember where branches are relative to their parent (or the root) before we move the chain
+	for (int32 Index = 0; Index < RootBranchNum; Index++)
+	{
+		BranchLocals[Index] = Hierarchy->GetLocalTransform(Branches[Index]);
+	}
+
+	if (RootBranchNum < BranchNum)
+	{
+		const FTransform Root = Hierarchy->GetGlobalTransform(Elements[0]);
+		for (int32 Index = RootBranchNum; Index < BranchNum; Index++)
+		{
+			BranchLocals[Index] = Hierarchy->GetGlobalTransform(Branches[Index]).GetRelativeTransform(Root);
+		}
+	}
+
+	// Every chain element is set explicitly, no need to propagate in between
+	for (int32 Index = 0; Index < Num - 1; Index++)
+	{
+		FRigTracedWrite::SetGlobalTransform(Hierarchy, Elements[Index], Transforms[Index], false, false);
+	}
+	FRigTracedWrite::SetGlobalTransform(Hierarchy, Elements.Last(), Transforms.Last(), false, Propagation != EPropagation::Off);
+
+	// Propagate each branch exactly once
+	for (int32 Index = 0; Index < RootBranchNum; Index++)
+	{
+		FRigTracedWrite::SetLocalTransform(Hierarchy, Branches[Index], BranchLocals[Index], false, true);
+	}
+
+	for (int32 Index = RootBranchNum; Index < BranchNum; Index++)
+	{
+		FRigTracedWrite::SetGlobalTransform(Hierarchy, Branches[Index], BranchLocals[Index] * Transforms[0], false, true);
+	}
+}
+
+FTransform FRigChainWriteBack::GetLocalTransform(const URigHierarchy* Hierarchy, int32 Index) const
+{
+	if (Links[Index])
+	{
+		return Hierarchy->GetLocalTransform(Elements[Index]);
+	}
+
+	// Whatever is in between follows the previous element when written back
+	return Hierarchy->GetGlobalTransform(Elements[Index]).GetRelativeTransform(Hierarchy->GetGlobalTransform(Elements[Index - 1]));
+}
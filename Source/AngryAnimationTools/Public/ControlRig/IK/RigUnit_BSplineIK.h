@@ -7,8 +7,26 @@
 
 #include "RigUnit_BSplineIK.generated.h"
 
+USTRUCT()
+struct ANGRYANIMATIONTOOLS_API FRigUnit_BSplineIK_WorkData
+{
+	GENERATED_BODY()
+
+	/** Cubic bezier point at given parameter */
+	static FVector Evaluate(const FVector& P0, const FVector& P1, const FVector& P2, const FVector& P3, float Alpha);
+
+	/** Builds the arc length table, the spline follows origin and objective so this is done every evaluation */
+	void Build(const FVector& P0, const FVector& P1, const FVector& P2, const FVector& P3, int32 SampleNum);
+
+	/** Spline parameter at given ratio of the total arc length */
+	float FindParameter(float Ratio) const;
+
+	/** Cumulative arc length at uniformly spaced spline parameters, kept to reuse the allocation */
+	TArray<float> ArcLengths;
+};
+
 /**
- * Moves a chain of bones along a B-Spline.
+ * Moves a chain of bones along a cubic bezier spline, bones are distributed by arc length.
  */
 USTRUCT(meta = (DisplayName = "B-Spline IK", Category = "IK", Keywords = "Angry,IK", PrototypeName = "BSplineIK", NodeColor = "1.0 0.44 0.0"))
 struct ANGRYANIMATIONTOOLS_API FRigUnit_BSplineIK : public FRigUnit_IK
@@ -57,4 +75,14 @@ public:
 	 */
 	UPROPERTY(meta = (Input))
 		EBendScaleType ScaleType = EBendScaleType::Default;
+
+	/**
+	 * Number of samples used to approximate arc length along the spline
+	 */
+	UPROPERTY(meta = (Input, Constant, DetailsOnly))
+		int32 ArcLengthSamples = 32;
+
+	// Cache
+	UPROPERTY(Transient)
+		FRigUnit_BSplineIK_WorkData WorkData;
 };
@@ -7,6 +7,18 @@
 
 #include "RigUnit_ConeFABRIK.generated.h"
 
+USTRUCT()
+struct FRigUnit_ConeFABRIK_WorkData
+{
+	GENERATED_BODY()
+
+	/** Inverse rest transform of each chain element */
+	TArray<FTransform> RestInverse;
+
+	/** Previous solve */
+	FRigWarmStart WarmStart;
+};
+
 /**
  * FABRIK with angle constraint
  */
@@ -23,6 +35,12 @@ struct ANGRYANIMATIONTOOLS_API FRigUnit_ConeFABRIK : public FRigUnit_IK
 public:
 	static FQuat SoftRotate(const FTransform& Local, const FTransform& Transform, const FTransform& Anchor, float MaxAngle);
 
+	// Walk from the root towards the end effector, returns how far the end effector ends up from the objective
+	static float FabrikForward(TArray<FTransform>& Transforms, const TArray<FTransform>& Rest, const FTransform& Forward, const FTransform& Backward, float MaxAngle);
+
+	// Walk from the end effector back to the root
+	static void FabrikBackward(TArray<FTransform>& Transforms, const TArray<FTransform>& RestInverse, const FTransform& Backward, float MaxAngle);
+
 	/*
 	 * Max angle change per segment
 	 */
@@ -34,4 +52,38 @@ public:
 	 */
 	UPROPERTY(meta = (Input, DetailsOnly))
 		int32 Iterations = 10;
+
+	/**
+	 * End effector distance at which the solver stops iterating
+	 */
+	UPROPERTY(meta = (Input, DetailsOnly))
+		float Tolerance = 0.01f;
+
+	/**
+	 * Number of iterations that were actually run
+	 */
+	UPROPERTY(meta = (Output))
+		int32 IterationsUsed = 0;
+
+	/**
+	 * Seed the solve with last frame's solution instead of the current pose, allows for fewer iterations
+	 */
+	UPROPERTY(meta = (Input, DetailsOnly))
+		bool bWarmStart = false;
+
+	/**
+	 * Root or objective movement since last frame at which the solve starts from the current pose again
+	 */
+	UPROPERTY(meta = (Input, DetailsOnly, EditCondition = "bWarmStart"))
+		float WarmStartThreshold = 50.0f;
+
+	/**
+	 * Quality reduction for distant characters
+	 */
+	UPROPERTY(meta = (Input, DetailsOnly))
+		FLODSettings LODSettings;
+
+	// Cache
+	UPROPERTY(Transient)
+		FRigUnit_ConeFABRIK_WorkData WorkData;
 };
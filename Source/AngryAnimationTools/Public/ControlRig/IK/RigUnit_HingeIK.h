@@ -7,6 +7,27 @@
 
 #include "RigUnit_HingeIK.generated.h"
 
+/**
+ * Hinge locations for many limbs at once, e.g. all legs of a crowd, solved the same way as FRigUnit_HingeIK.
+ * Limbs are stored in blocks of 4 with each value laid out across the block for 4-wide vector math.
+ * Results are written back per rig by bending each limb towards its hinge and objective.
+ */
+struct ANGRYANIMATIONTOOLS_API FHingeIKBatch
+{
+	void Reset(int32 Num);
+	void Set(int32 Index, const FVector& Root, const FVector& Target, const FVector& Direction, float UpperLength, float LowerLength);
+
+	/** Computes the hinge location of every limb */
+	void Solve();
+
+	FVector GetHinge(int32 Index) const;
+
+	int32 Num = 0;
+	TArray<float> Lanes;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
 /**
  * Simple analytic IK solver for a hinge joint.
  */
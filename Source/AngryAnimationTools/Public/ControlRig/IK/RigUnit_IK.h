@@ -12,6 +12,84 @@
 #define GET_IK_OBJECTIVE_RIGHT() -Objective.GetUnitAxis(EAxis::X)
 #define GET_IK_OBJECTIVE_UP() Objective.GetUnitAxis(EAxis::Z)
 
+USTRUCT()
+struct ANGRYANIMATIONTOOLS_API FRigUnit_IK_WorkData
+{
+	GENERATED_BODY()
+
+	/**
+	 * Resolves the chain and its rest pose data, only does work if the chain or the hierarchy topology changed.
+	 * Returns false if any chain element is invalid.
+	 */
+	bool Update(const FRigElementKeyCollection& Chain, const URigHierarchy* Hierarchy);
+
+	/** Resolved chain elements */
+	UPROPERTY()
+		TArray<FCachedRigElement> CachedChain;
+
+	/** Initial global transform of each chain element */
+	UPROPERTY()
+		TArray<FTransform> InitialTransforms;
+
+	/** Initial length of each segment, one less than the chain */
+	UPROPERTY()
+		TArray<float> InitialLengths;
+
+	/** Initial location of each chain element relative to the chain root */
+	UPROPERTY()
+		TArray<FVector> InitialDeltas;
+
+	/** Sum of all initial segment lengths */
+	UPROPERTY()
+		float InitialChainLength = 0.0f;
+
+	/** Batched hierarchy write-back for chain solvers */
+	UPROPERTY()
+		FRigChainWriteBack WriteBack;
+
+	UPROPERTY()
+		int32 TopologyVersion = INDEX_NONE;
+
+	/** Incremented whenever the rest pose data is rebuilt */
+	UPROPERTY()
+		int32 Revision = 0;
+
+	UPROPERTY()
+		bool bIsValid = false;
+
+	/** Debug primitives recorded by the solver */
+	FRigDebugBuffer DebugBuffer;
+};
+
+/** Solved chain of the previous frame relative to the chain root, used to seed iterative solvers */
+USTRUCT()
+struct ANGRYANIMATIONTOOLS_API FRigWarmStart
+{
+	GENERATED_BODY()
+
+	/**
+	 * Seeds transforms with the previous solve rebased onto the current root.
+	 * Returns false without touching the transforms if there is no previous solve, the chain changed
+	 * or root or objective moved further than Threshold since then (e.g. teleports).
+	 */
+	bool Apply(TArray<FTransform>& Transforms, const FTransform& Root, const FTransform& Objective, int32 Revision, float Threshold) const;
+
+	/** Stores the solved chain relative to its root */
+	void Store(const TArray<FTransform>& Transforms, const FTransform& Root, const FTransform& Objective, int32 Revision);
+
+	void Reset();
+
+	/** Solved transforms relative to the root */
+	TArray<FTransform> Relative;
+
+	/** Root and objective of the previous solve */
+	FTransform PreviousRoot;
+	FVector PreviousObjective = FVector::ZeroVector;
+
+	/** Chain cache revision the solve was made for */
+	int32 Revision = INDEX_NONE;
+};
+
 /** Base class for all IK nodes */
 USTRUCT(BlueprintType, meta = (Abstract))
 struct ANGRYANIMATIONTOOLS_API FRigUnit_IK : public FRigUnitMutable
@@ -58,4 +136,8 @@ public:
 	 */
 	UPROPERTY(meta = (Input, DetailsOnly))
 		FDebugSettings DebugSettings;
+
+	// Cache
+	UPROPERTY(Transient)
+		FRigUnit_IK_WorkData ChainCache;
 };
@@ -34,7 +34,23 @@ struct ANGRYANIMATIONTOOLS_API FSpineEffectorSettings
 		float LimitRadius = 0.0f;
 };
 
+USTRUCT()
+struct FRigUnit_SpineIK_WorkData
+{
+	GENERATED_BODY()
 
+	/** Local transforms of the chain at the start of the solve and their inverse */
+	TArray<FTransform> Rest;
+	TArray<FTransform> RestInverse;
+	TArray<float> RestLengths;
+
+	/** Chains solved from either end */
+	TArray<FTransform> StartChain;
+	TArray<FTransform> EndChain;
+
+	/** Previous solve */
+	FRigWarmStart WarmStart;
+};
 
 /**
  * IK solver for a chain of bones that connects the chain with a target while also maintaining the general shape of that chain.
@@ -69,4 +85,25 @@ public:
 	UPROPERTY(meta = (Input, DetailsOnly))
 		int32 Iterations = 10;
 
+	/**
+	 * Seed the solve with last frame's solution instead of the current pose, allows for fewer iterations
+	 */
+	UPROPERTY(meta = (Input, DetailsOnly))
+		bool bWarmStart = false;
+
+	/**
+	 * Root or objective movement since last frame at which the solve starts from the current pose again
+	 */
+	UPROPERTY(meta = (Input, DetailsOnly, EditCondition = "bWarmStart"))
+		float WarmStartThreshold = 50.0f;
+
+	/**
+	 * Quality reduction for distant characters
+	 */
+	UPROPERTY(meta = (Input, DetailsOnly))
+		FLODSettings LODSettings;
+
+	// Cache
+	UPROPERTY(Transient)
+		FRigUnit_SpineIK_WorkData WorkData;
 };
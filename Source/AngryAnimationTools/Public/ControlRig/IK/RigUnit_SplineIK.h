@@ -0,0 +1,107 @@
+#pragma once
+
+#include "RigUnit_IK.h"
+#include "ControlRig/Utility.h"
+
+#include "RigUnit_SplineIK.generated.h"
+
+USTRUCT()
+struct FRigUnit_SplineIK_WorkData
+{
+	GENERATED_BODY()
+
+	/** Uniform catmull-rom point on given segment, points outside the key range are extrapolated */
+	FVector Evaluate(int32 Segment, float Alpha) const;
+
+	/** Uniform catmull-rom tangent on given segment */
+	FVector Derivative(int32 Segment, float Alpha) const;
+
+	/** Arc length on given segment between two parameters */
+	float Integrate(int32 Segment, float From, float To) const;
+
+	/**
+	 * Places each chain element on the spline by arc length. Bone ratios are only rebuilt if the chain or position changed,
+	 * bone parameters are refined from the previous evaluation so no arc length table is built for the current keys.
+	 */
+	void Update(const FRigUnit_IK_WorkData& ChainCache, float PositionAlongSpline, int32 Iterations);
+
+	/** Spline keys for the current frame */
+	TArray<FVector> Points;
+
+	/** Arc length of each segment for the current keys */
+	TArray<float> SegmentLengths;
+
+	/** Accumulated twist angle at each key */
+	TArray<float> TwistAngles;
+
+	/** Ratio of the total arc length each chain element is placed at, from rest lengths */
+	TArray<float> BoneRatios;
+
+	/** Spline segment each chain element is placed on */
+	TArray<int32> BoneSegments;
+
+	/** Parameter within its segment each chain element is placed at */
+	TArray<float> BoneAlphas;
+
+	/** Inputs the bone ratios and parameters were built for */
+	int32 CachedRevision = INDEX_NONE;
+	int32 CachedKeyNum = INDEX_NONE;
+	float CachedPositionAlongSpline = 0.0f;
+};
+
+/**
+ * Moves a chain of bones along a spline through the chain root, an arbitrary number of controls and the objective, bones are distributed by arc length.
+ * Twist is interpolated between the control rotations along the curve.
+ */
+USTRUCT(meta = (DisplayName = "Spline IK", Category = "IK", Keywords = "Angry,IK", PrototypeName = "SplineIK", NodeColor = "1.0 0.44 0.0"))
+struct ANGRYANIMATIONTOOLS_API FRigUnit_SplineIK : public FRigUnit_IK
+{
+	GENERATED_BODY()
+
+		FRigUnit_SplineIK() {}
+
+	RIGVM_METHOD()
+		virtual void Execute() override;
+
+public:
+
+	/**
+	 * Controls the spline passes through between chain root and objective
+	 */
+	UPROPERTY(meta = (Input))
+		TArray<FTransform> Controls;
+
+	/**
+	 * How much of the twist between controls is applied to the chain
+	 */
+	UPROPERTY(meta = (Input))
+		float Twist = 1.0f;
+
+	/**
+	 * How much objective should rotate with last tangent instead of objective
+	 */
+	UPROPERTY(meta = (Input, DetailsOnly))
+		float RotateWithTangent = 1.0f;
+
+	/**
+	 * Position along spline between (0 for start and 1 for end)
+	 */
+	UPROPERTY(meta = (Input))
+		float PositionAlongSpline = 1.0f;
+
+	/**
+	* How to scale the bones
+	 */
+	UPROPERTY(meta = (Input))
+		EBendScaleType ScaleType = EBendScaleType::Default;
+
+	/**
+	 * Newton steps per bone refining its arc length position from the previous evaluation
+	 */
+	UPROPERTY(meta = (Input, DetailsOnly))
+		int32 ArcLengthIterations = 2;
+
+	// Cache
+	UPROPERTY(Transient)
+		FRigUnit_SplineIK_WorkData WorkData;
+};
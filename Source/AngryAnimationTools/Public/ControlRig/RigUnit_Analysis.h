@@ -46,7 +46,7 @@ public:
 };
 
 /**
- * Computes the main direction of a chain of bones using the power method (first row of SVD)
+ * Computes the principal directions of a chain of bones from the eigen decomposition of its covariance
  */
 USTRUCT(meta = (DisplayName = "Power Direction", Category = "Analysis", Keywords = "Angry,Utility", PrototypeName = "PowerDirection", NodeColor = "1.0 0.44 0.0"))
 struct ANGRYANIMATIONTOOLS_API FRigUnit_PowerDirection : public FRigUnit
@@ -59,6 +59,8 @@ struct ANGRYANIMATIONTOOLS_API FRigUnit_PowerDirection : public FRigUnit
 		virtual void Execute() override;
 
 public:
+	// Jacobi eigen decomposition of a symmetric matrix, axes are sorted by descending eigenvalue and form a right handed frame
+	static void ComputeSymmetricEigen(const double (&Matrix)[3][3], FVector& EigenValues, FVector (&Axes)[3]);
 
 	/**
 	 * The chain to compute the direction for
@@ -67,16 +69,34 @@ public:
 		FRigElementKeyCollection Chain;
 
 	/**
-	 * Number of power iterations
+	 * Deprecated, directions are computed in fixed time
 	 */
-	UPROPERTY(meta = (Input))
+	UPROPERTY(meta = (Input, DetailsOnly))
 		int32 Iterations = 8;
 
+	/**
+	 * Quality reduction for distant characters
+	 */
+	UPROPERTY(meta = (Input, DetailsOnly))
+		FLODSettings LODSettings;
+
 	/**
 	 * Computed direction
 	 */
 	UPROPERTY(meta = (Output))
 		FVector Output = FVector::ForwardVector;
+
+	/**
+	 * Chain aligned frame at the chain centroid, X along the main direction and Z along the least spread
+	 */
+	UPROPERTY(meta = (Output))
+		FTransform Frame;
+
+	/**
+	 * Variance of the chain along each frame axis
+	 */
+	UPROPERTY(meta = (Output))
+		FVector EigenValues = FVector::ZeroVector;
 };
 
 
@@ -21,7 +21,11 @@ struct ANGRYANIMATIONTOOLS_API FRigUnit_BendTowards : public FRigUnitMutable
 		virtual void Execute() override;
 
 public:
+	// Computes the bent transform of the current element and the resulting transform of the next element without touching the hierarchy
+	static FTransform BendTransform(const FTransform& Current, const FTransform& Local, const FVector& Target, EBendScaleType type, float Intensity, FTransform& Next);
+
 	static FTransform BendTowards(const FRigElementKey& Key, const FRigElementKey& NextKey, const FVector& Target, URigHierarchy* Hierarchy, EBendScaleType type, bool bPropagateToChildren, float Intensity = 1.0f);
+	static FTransform BendTowards(const FCachedRigElement& Current, const FCachedRigElement& Next, const FVector& Target, URigHierarchy* Hierarchy, EBendScaleType type, bool bPropagateToChildren, float Intensity = 1.0f);
 
 	/**
 	* Starting key
@@ -10,6 +10,16 @@
 #include "Animation/InputScaleBias.h"
 #include "RigUnit_Ellipsoid.generated.h"
 
+UENUM(BlueprintType)
+enum class EEllipsoidProjectionMode : uint8
+{
+	/** Intersect along a scale warped ray, biased for strongly non-uniform scale */
+	Raycast,
+	/** Newton iterations on the exact closest point equation */
+	Newton,
+	/** First order distance estimate, cheapest but only exact close to the surface */
+	Approximate
+};
 
 USTRUCT(BlueprintType)
 struct FEllipsoid
@@ -32,6 +42,158 @@ struct FEllipsoid
 		FRigElementKey Key = FRigElementKey(FName(), ERigElementType::Control);
 };
 
+/**
+ * Ellipsoid transform as world to ellipsoid space matrices, so queries against prepared ellipsoids are plain matrix products.
+ * Ellipsoid space is scaled so the ellipsoid is a sphere, unscaled space only removes rotation and translation.
+ */
+struct ANGRYANIMATIONTOOLS_API FEllipsoidSpace
+{
+	FEllipsoidSpace() = default;
+	explicit FEllipsoidSpace(const FTransform& Transform);
+
+	FORCEINLINE FVector GetLocation() const { return ToWorld.GetOrigin(); }
+
+	FORCEINLINE FVector InverseTransformPosition(const FVector& Position) const { return ToLocal.TransformPosition(Position); }
+	FORCEINLINE FVector InverseTransformVector(const FVector& Vector) const { return ToLocal.TransformVector(Vector); }
+	FORCEINLINE FVector TransformPosition(const FVector& Position) const { return ToWorld.TransformPosition(Position); }
+
+	/** World direction of a sphere normal in ellipsoid space, not normalized */
+	FORCEINLINE FVector TransformNormal(const FVector& Normal) const { return ToWorld.TransformVector(Normal * InvScale * InvScale); }
+
+	FORCEINLINE FVector InverseTransformPositionNoScale(const FVector& Position) const { return ToLocal.TransformPosition(Position) * Scale; }
+	FORCEINLINE FVector TransformPositionNoScale(const FVector& Position) const { return ToWorld.TransformPosition(Position * InvScale); }
+	FORCEINLINE FVector TransformVectorNoScale(const FVector& Vector) const { return ToWorld.TransformVector(Vector * InvScale); }
+
+	FMatrix ToLocal = FMatrix::Identity;
+	FMatrix ToWorld = FMatrix::Identity;
+	FVector Scale = FVector::OneVector;
+	FVector InvScale = FVector::OneVector;
+};
+
+/**
+ * Ellipsoid inverse transforms prepared for raycasting against many ellipsoids at once.
+ * Ellipsoids are stored in blocks of 4 with each value laid out across the block for 4-wide vector math.
+ */
+struct ANGRYANIMATIONTOOLS_API FEllipsoidBatch
+{
+	void Reset(int32 Num);
+	void Set(int32 Index, const FTransform& Transform, float Radius);
+
+	/**
+	 * Finds the nearest hit of each ray among all ellipsoids, matching ComputeEllispoidRaycast.
+	 * Times are 1 and hits INDEX_NONE for rays that don't intersect anything, outputs need to be sized to the number of rays.
+	 */
+	void Raycast(TConstArrayView<FVector> Starts, TConstArrayView<FVector> Ends, TArrayView<float> Times, TArrayView<int32> Hits) const;
+
+	int32 Num = 0;
+	TArray<float> Lanes;
+};
+
+/**
+ * Damped springs integrated together in fixed steps so results don't depend on the frame rate.
+ * Values are interpolated between the last two steps, leftover time is carried over to the next update.
+ */
+struct ANGRYANIMATIONTOOLS_API FSpringBatch
+{
+	/** Resizes to Num springs resting at Value */
+	void Reset(int32 Num, float Value);
+
+	/** Advances all springs towards their targets, damping is relative to critical damping */
+	void Update(float DeltaTime, float Stiffness, float Damping);
+
+	float GetValue(int32 Index) const;
+
+	TArray<float> Targets;
+	TArray<float> PreviousTargets;
+	TArray<float> Values;
+	TArray<float> PreviousValues;
+	TArray<float> Velocities;
+	float Accumulator = 0.0f;
+	bool bHasTargets = false;
+};
+
+/**
+ * Ellipsoids resolved once per evaluation so multiple ellipsoid nodes don't each look up and prepare the same controls.
+ * Transforms already have near zero scale axes clamped, spaces and the batch hold the matching matrices.
+ */
+USTRUCT(BlueprintType)
+struct ANGRYANIMATIONTOOLS_API FEllipsoidColliderSet
+{
+	GENERATED_BODY()
+
+	void Reset(int32 Num);
+	void Set(int32 Index, const FTransform& Transform, float Radius);
+
+	int32 Num() const { return Transforms.Num(); }
+	bool IsValidIndex(int32 Index) const { return Valid.IsValidIndex(Index) && Valid[Index]; }
+
+	/**
+	* Scale clamped global transform of each ellipsoid
+	*/
+	UPROPERTY()
+		TArray<FTransform> Transforms;
+
+	/**
+	* Radius of each unscaled sphere
+	*/
+	UPROPERTY()
+		TArray<float> Radii;
+
+	/**
+	* Bounding sphere of each ellipsoid
+	*/
+	UPROPERTY()
+		TArray<FVector> BoundCenters;
+
+	UPROPERTY()
+		TArray<float> BoundRadii;
+
+	/**
+	* Whether each ellipsoid could be resolved, invalid ellipsoids never collide
+	*/
+	UPROPERTY()
+		TArray<bool> Valid;
+
+	/** World to ellipsoid space of each ellipsoid for single queries */
+	TArray<FEllipsoidSpace> Spaces;
+
+	FEllipsoidBatch Batch;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Resolves a collection of ellipsoids into a collider set that can be shared between ellipsoid nodes
+ */
+USTRUCT(meta = (DisplayName = "Ellipsoid Collider Set", Category = "Ellipsoid", Keywords = "Ellipsoid", PrototypeName = "EllipsoidColliderSet", NodeColor = "1.0 0.44 0.0"))
+struct ANGRYANIMATIONTOOLS_API FRigUnit_EllipsoidColliderSet : public FRigUnit
+{
+	GENERATED_BODY()
+
+		FRigUnit_EllipsoidColliderSet() {}
+
+	RIGVM_METHOD()
+		virtual void Execute() override;
+
+public:
+
+	/**
+	* Ellipsoids to resolve
+	*/
+	UPROPERTY(meta = (Input))
+		TArray<FEllipsoid> Ellipsoids;
+
+	/**
+	* Prepared ellipsoids in the same order
+	*/
+	UPROPERTY(meta = (Output))
+		FEllipsoidColliderSet ColliderSet;
+
+	// Cache
+	UPROPERTY(Transient)
+		TArray<FCachedRigElement> EllipsoidCaches;
+};
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 /**
@@ -49,6 +211,14 @@ struct ANGRYANIMATIONTOOLS_API FRigUnit_EllipsoidProjection : public FRigUnit
 
 public:
 	static void ComputeEllispoidProjection(const FTransform& Transform, float Radius, const FVector& Point, FVector& Closest, FVector& Normal);
+	static void ComputeEllispoidProjectionNewton(const FTransform& Transform, float Radius, const FVector& Point, int32 Iterations, FVector& Closest, FVector& Normal);
+	static void ComputeEllispoidProjectionApproximate(const FTransform& Transform, float Radius, const FVector& Point, FVector& Closest, FVector& Normal);
+	static void ComputeEllispoidProjection(EEllipsoidProjectionMode Mode, int32 Iterations, const FTransform& Transform, float Radius, const FVector& Point, FVector& Closest, FVector& Normal);
+
+	static void ComputeEllispoidProjection(const FEllipsoidSpace& Space, float Radius, const FVector& Point, FVector& Closest, FVector& Normal);
+	static void ComputeEllispoidProjectionNewton(const FEllipsoidSpace& Space, float Radius, const FVector& Point, int32 Iterations, FVector& Closest, FVector& Normal);
+	static void ComputeEllispoidProjectionApproximate(const FEllipsoidSpace& Space, float Radius, const FVector& Point, FVector& Closest, FVector& Normal);
+	static void ComputeEllispoidProjection(EEllipsoidProjectionMode Mode, int32 Iterations, const FEllipsoidSpace& Space, float Radius, const FVector& Point, FVector& Closest, FVector& Normal);
 
 	/**
 	* Ellipsoid used for collision
@@ -56,6 +226,18 @@ public:
 	UPROPERTY(meta = (Input))
 		FEllipsoid Ellipsoid;
 
+	/**
+	* Prepared ellipsoids, used instead of Ellipsoid if ColliderIndex is set
+	*/
+	UPROPERTY(meta = (Input))
+		FEllipsoidColliderSet ColliderSet;
+
+	/**
+	* Ellipsoid in ColliderSet to use, INDEX_NONE to use Ellipsoid
+	*/
+	UPROPERTY(meta = (Input))
+		int32 ColliderIndex = INDEX_NONE;
+
 	/**
 	* Projection point
 	*/
@@ -74,6 +256,18 @@ public:
 	UPROPERTY(meta = (Output))
 		FVector Normal = FVector::ForwardVector;
 
+	/**
+	* How to find the closest point
+	*/
+	UPROPERTY(meta = (Input, DetailsOnly))
+		EEllipsoidProjectionMode ProjectionMode = EEllipsoidProjectionMode::Raycast;
+
+	/**
+	* Newton iterations, only used by the Newton projection mode
+	*/
+	UPROPERTY(meta = (Input, DetailsOnly))
+		int32 Iterations = 4;
+
 	/**
 	 * Debug settings
 	 */
@@ -104,6 +298,7 @@ struct ANGRYANIMATIONTOOLS_API FRigUnit_EllipsoidPointPlaneProject : public FRig
 
 public:
 	static float ComputeEllispoidPointPlaneProject(const FTransform& Transform, float Radius, const FVector& Point, const FVector& Normal, FVector& Projected);
+	static float ComputeEllispoidPointPlaneProject(const FEllipsoidSpace& Space, float Radius, const FVector& Point, const FVector& Normal, FVector& Projected);
 
 	/**
 	* Ellipsoid used for the dot product
@@ -111,6 +306,18 @@ public:
 	UPROPERTY(meta = (Input))
 		FEllipsoid Ellipsoid;
 
+	/**
+	* Prepared ellipsoids, used instead of Ellipsoid if ColliderIndex is set
+	*/
+	UPROPERTY(meta = (Input))
+		FEllipsoidColliderSet ColliderSet;
+
+	/**
+	* Ellipsoid in ColliderSet to use, INDEX_NONE to use Ellipsoid
+	*/
+	UPROPERTY(meta = (Input))
+		int32 ColliderIndex = INDEX_NONE;
+
 	/**
 	* Point in global space for plane projectyion
 	*/
@@ -164,12 +371,27 @@ struct ANGRYANIMATIONTOOLS_API FRigUnit_EllipsoidRaycast : public FRigUnit
 public:
 	static float ComputeEllispoidRaycast(const FTransform& Transform, float Radius, const FVector& Start, const FVector& End, FVector& Impact, FVector& Normal, float& Distance);
 
+	/** Space needs to be built from a scale clamped transform, as collider set spaces are */
+	static float ComputeEllispoidRaycast(const FEllipsoidSpace& Space, float Radius, const FVector& Start, const FVector& End, FVector& Impact, FVector& Normal, float& Distance);
+
 	/**
 	* Ellipsoids used for collision
 	*/
 	UPROPERTY(meta = (Input))
 		FEllipsoid Ellipsoid;
 
+	/**
+	* Prepared ellipsoids, used instead of Ellipsoid if ColliderIndex is set
+	*/
+	UPROPERTY(meta = (Input))
+		FEllipsoidColliderSet ColliderSet;
+
+	/**
+	* Ellipsoid in ColliderSet to use, INDEX_NONE to use Ellipsoid
+	*/
+	UPROPERTY(meta = (Input))
+		int32 ColliderIndex = INDEX_NONE;
+
 	/**
 	* Raycast start point
 	*/
@@ -228,6 +450,14 @@ public:
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+USTRUCT()
+struct FRigUnit_EllipsoidRaycastMulti_WorkData
+{
+	GENERATED_BODY()
+
+	FEllipsoidBatch EllipsoidBatch;
+};
+
 /**
  * Intersect a line segment with a collection of ellipsoids
  */
@@ -249,6 +479,12 @@ public:
 	UPROPERTY(meta = (Input))
 		TArray<FEllipsoid> Ellipsoids;
 
+	/**
+	* Prepared ellipsoids, used instead of Ellipsoids if not empty
+	*/
+	UPROPERTY(meta = (Input))
+		FEllipsoidColliderSet ColliderSet;
+
 	/**
 	* Raycast start point
 	*/
@@ -289,6 +525,9 @@ public:
 	// Cache
 	UPROPERTY(Transient)
 		TArray<FCachedRigElement> EllipsoidCaches;
+
+	UPROPERTY(Transient)
+		FRigUnit_EllipsoidRaycastMulti_WorkData WorkData;
 };
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -309,15 +548,6 @@ struct FRigUnit_EllipsoidRingCastItem_WorkData
 
 	UPROPERTY()
 		float TargetTime;
-
-	UPROPERTY()
-		float CurrentTime;
-
-	UPROPERTY()
-		bool bIsInitialised;
-
-	UPROPERTY()
-		FFloatSpringState SpringState;
 };
 
 USTRUCT()
@@ -330,6 +560,24 @@ struct FRigUnit_EllipsoidRingCast_WorkData
 
 	UPROPERTY()
 		TArray<FRigUnit_EllipsoidRingCastItem_WorkData> ItemCaches;
+
+	FEllipsoidBatch EllipsoidBatch;
+	FSpringBatch Springs;
+	TArray<FVector> RayStarts;
+	TArray<FVector> RayEnds;
+	TArray<float> RayTimes;
+	TArray<int32> RayHits;
+
+	/** Offset ranges whose neighbour weight clamps to 1, these reduce to a sliding window minimum */
+	TArray<FIntPoint> KernelBands;
+
+	/** Remaining neighbour weights by index offset, only offsets with weights above a cutoff are kept */
+	TArray<int32> KernelOffsets;
+	TArray<float> KernelWeights;
+	TArray<float> KernelTimes;
+	TArray<int32> KernelQueue;
+	int32 KernelItemNum = 0;
+	float KernelVariance = 0.0f;
 };
 
 /**
@@ -353,6 +601,12 @@ public:
 	UPROPERTY(meta = (Input))
 		TArray<FEllipsoid> Ellipsoids;
 
+	/**
+	* Prepared ellipsoids, used instead of Ellipsoids if not empty
+	*/
+	UPROPERTY(meta = (Input))
+		FEllipsoidColliderSet ColliderSet;
+
 	/**
 	 * Bones of the ring to adapt cast to the ellipsoid
 	 */
@@ -417,6 +671,7 @@ struct ANGRYANIMATIONTOOLS_API FRigUnit_EllipsoidLineCollide : public FRigUnit
 
 public:
 	static FVector ComputeEllispoidLineCollide(const FTransform& Transform, float Radius, const FVector& Start, const FVector& End, const FVector& Direction, float Adapt);
+	static FVector ComputeEllispoidLineCollide(const FEllipsoidSpace& Space, float Radius, const FVector& Start, const FVector& End, const FVector& Direction, float Adapt);
 
 	/**
 	* Ellipsoid used for collision
@@ -424,6 +679,18 @@ public:
 	UPROPERTY(meta = (Input))
 		FEllipsoid Ellipsoid;
 
+	/**
+	* Prepared ellipsoids, used instead of Ellipsoid if ColliderIndex is set
+	*/
+	UPROPERTY(meta = (Input))
+		FEllipsoidColliderSet ColliderSet;
+
+	/**
+	* Ellipsoid in ColliderSet to use, INDEX_NONE to use Ellipsoid
+	*/
+	UPROPERTY(meta = (Input))
+		int32 ColliderIndex = INDEX_NONE;
+
 	/**
 	* Line start
 	*/
@@ -467,8 +734,151 @@ public:
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+USTRUCT()
+struct FRigUnit_EllipsoidLineCollideMulti_WorkData
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+		TArray<FCachedRigElement> PivotCaches;
+
+	UPROPERTY()
+		TArray<FCachedRigElement> TipCaches;
+
+	/** Rebuilds segment order, parents and write-back elements if the pivots or the hierarchy topology changed */
+	void Update(const URigHierarchy* Hierarchy);
+
+	/** Pivot element of each segment the topology was built for, INDEX_NONE for invalid segments */
+	TArray<int32> PivotElements;
+
+	int32 TopologyVersion = INDEX_NONE;
+
+	/** Valid segments sorted by depth so parents are solved first, indexed by slot */
+	TArray<int32> Order;
+	TArray<int32> Parents;
+	TArray<int32> LevelOffsets;
+
+	/** Elements between a pivot and its parent pivot, these follow the solved parent */
+	TArray<int32> Connectors;
+	TArray<int32> ConnectorParents;
+	TArray<FTransform> ConnectorTransforms;
+
+	/** Children of written elements that aren't written themselves, propagated once after writing */
+	TArray<int32> Branches;
+	TArray<FTransform> BranchLocals;
+
+	/** Segments laid out as separate arrays by slot so each ellipsoid is applied to a whole level in one loop */
+	TArray<FTransform> Initials;
+	TArray<FTransform> Solved;
+	TArray<FVector> TipLocals;
+	TArray<FVector> Starts;
+	TArray<FVector> Tips;
+	TArray<FVector> Ends;
+	TArray<FVector> Directions;
+
+	/** Debug primitives recorded while solving, drawn after the write-back */
+	FRigDebugBuffer DebugBuffer;
+};
+
 /**
- * Ellipsoid collision for a rotating chain. This uses projection between points along each chain bone and the ellipsoid.
+ * Collides many line segments with a set of ellipsoids, e.g. for hair cards or whiskers.
+ * Each pivot is rotated so its tip follows the deflected line. Segments whose pivot is below another pivot
+ * are solved after and relative to that segment, so strands stay connected.
+ */
+USTRUCT(meta = (DisplayName = "Ellipsoid Line Collision Multi", Category = "Ellipsoid", Keywords = "Ellipsoid", PrototypeName = "EllipsoidLineCollision", NodeColor = "1.0 0.44 0.0"))
+struct ANGRYANIMATIONTOOLS_API FRigUnit_EllipsoidLineCollideMulti : public FRigUnitMutable
+{
+	GENERATED_BODY()
+
+		FRigUnit_EllipsoidLineCollideMulti() {}
+
+	RIGVM_METHOD()
+		virtual void Execute() override;
+
+public:
+	/** Deflects all line ends by one ellipsoid, zero length lines are skipped */
+	static void ComputeEllispoidLineCollideBatch(const FEllipsoidSpace& Space, float Radius, TConstArrayView<FVector> Starts, TArrayView<FVector> Ends, TConstArrayView<FVector> Directions, float Adapt);
+
+	/**
+	* Ellipsoids used for collision
+	*/
+	UPROPERTY(meta = (Input))
+		FEllipsoidColliderSet ColliderSet;
+
+	/**
+	 * Line start of each segment, these are rotated
+	 */
+	UPROPERTY(meta = (Input, ExpandByDefault))
+		FRigElementKeyCollection Pivots;
+
+	/**
+	 * Line end of each segment
+	 */
+	UPROPERTY(meta = (Input, ExpandByDefault))
+		FRigElementKeyCollection Tips;
+
+	/**
+	* Sweep direction in the space of each pivot
+	*/
+	UPROPERTY(meta = (Input))
+		FVector Direction = FVector::ForwardVector;
+
+	/**
+	* Distance in which we smoothly lerp if outside collision radius instead of snapping
+	*/
+	UPROPERTY(meta = (Input, DetailsOnly))
+		float Adapt = 50.0f;
+
+	/**
+	 * Debug settings
+	 */
+	UPROPERTY(meta = (Input, DetailsOnly))
+		FDebugSettings DebugSettings;
+
+	// Cache
+	UPROPERTY(Transient)
+		FRigUnit_EllipsoidLineCollideMulti_WorkData WorkData;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+USTRUCT()
+struct FRigUnit_EllipsoidChainCollide_WorkData
+{
+	GENERATED_BODY()
+
+	/** Projects onto the closest candidate ellipsoid, skipping ellipsoids whose bounding sphere is further away than the best hit */
+	void Project(EEllipsoidProjectionMode Mode, int32 Iterations, const FVector& Point, FVector& Closest, FVector& Normal);
+
+	/** Finds where a collision point moving from its previous frame location first entered a candidate ellipsoid, false if it didn't */
+	bool Sweep(int32 Segment, const FVector& Point, FVector& Impact, FVector& Normal) const;
+
+	UPROPERTY()
+		TArray<FCachedRigElement> EllipsoidCaches;
+
+	/** Ellipsoids in reach of the chain */
+	TArray<int32> Candidates;
+	TArray<TPair<float, int32>> CandidateBounds;
+
+	/** Ellipsoid spaces, radii and bounding spheres */
+	TArray<FEllipsoidSpace> Spaces;
+	TArray<float> Radii;
+	TArray<FVector> BoundCenters;
+	TArray<float> BoundRadii;
+
+	/** Whether each ellipsoid resolved this frame, entries of invalid ellipsoids are left unset */
+	TArray<bool> Valid;
+
+	/** Collision point of each segment and ellipsoid spaces of the previous frame, only kept for swept collision */
+	TArray<FVector> PreviousPoints;
+	TArray<FEllipsoidSpace> PreviousSpaces;
+
+	/** Ellipsoids that were valid last frame, only these have a usable previous space */
+	TArray<bool> PreviousValid;
+};
+
+/**
+ * Ellipsoid collision for a rotating chain. This uses projection between points along each chain bone and the closest ellipsoid.
  */
 USTRUCT(meta = (DisplayName = "Ellipsoid Chain Collision", Category = "Ellipsoid", Keywords = "Ellipsoid", PrototypeName = "EllipsoidChainCollision", NodeColor = "1.0 0.44 0.0"))
 struct ANGRYANIMATIONTOOLS_API FRigUnit_EllipsoidChainCollide : public FRigUnitMutable
@@ -483,11 +893,23 @@ struct ANGRYANIMATIONTOOLS_API FRigUnit_EllipsoidChainCollide : public FRigUnitM
 public:
 
 	/**
-	* Ellipsoid used for collision
+	* Ellipsoids used for collision
 	*/
 	UPROPERTY(meta = (Input))
+		TArray<FEllipsoid> Ellipsoids;
+
+	/**
+	* Deprecated, use Ellipsoids. Collided with in addition to Ellipsoids if its key is set
+	*/
+	UPROPERTY(meta = (Input, DetailsOnly))
 		FEllipsoid Ellipsoid;
 
+	/**
+	* Prepared ellipsoids, used instead of Ellipsoids if not empty
+	*/
+	UPROPERTY(meta = (Input))
+		FEllipsoidColliderSet ColliderSet;
+
 	/**
 	 * The chain to adapt (Has to be continuous chain)
 	 */
@@ -536,6 +958,24 @@ public:
 	UPROPERTY(meta = (Input))
 		EBendScaleType ScaleType = EBendScaleType::None;
 
+	/**
+	* How to find the closest point on each ellipsoid
+	*/
+	UPROPERTY(meta = (Input, DetailsOnly))
+		EEllipsoidProjectionMode ProjectionMode = EEllipsoidProjectionMode::Raycast;
+
+	/**
+	* Newton iterations, only used by the Newton projection mode
+	*/
+	UPROPERTY(meta = (Input, DetailsOnly))
+		int32 Iterations = 4;
+
+	/**
+	* Sweep collision points from their previous frame location so segments can't tunnel through fast moving ellipsoids
+	*/
+	UPROPERTY(meta = (Input, DetailsOnly))
+		bool bSwept = false;
+
 	/**
 	 * If set to true all of the global transforms of the children
 	 * of the chain bones will be recalculated based on their local transforms.
@@ -551,7 +991,10 @@ public:
 
 	// Cache
 	UPROPERTY(Transient)
-		FCachedRigElement EllipsoidCache;
+		FRigUnit_EllipsoidChainCollide_WorkData WorkData;
+
+	UPROPERTY(Transient)
+		FRigUnit_IK_WorkData ChainCache;
 };
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -577,6 +1020,18 @@ public:
 	UPROPERTY(meta = (Input))
 		FEllipsoid Ellipsoid;
 
+	/**
+	* Prepared ellipsoids, used instead of Ellipsoid if ColliderIndex is set
+	*/
+	UPROPERTY(meta = (Input))
+		FEllipsoidColliderSet ColliderSet;
+
+	/**
+	* Ellipsoid in ColliderSet to use, INDEX_NONE to use Ellipsoid
+	*/
+	UPROPERTY(meta = (Input))
+		int32 ColliderIndex = INDEX_NONE;
+
 	/**
 	 * Local objective offset rotation
 	 */
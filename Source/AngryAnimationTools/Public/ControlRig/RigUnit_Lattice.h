@@ -24,10 +24,34 @@ struct FRigUnit_LatticeTransform_WorkData
 {
 	GENERATED_BODY()
 
-	TArray<TArray<float>> Weights;
+	/** Lattice weights per chain element in compressed sparse rows, row i is [WeightOffsets[i], WeightOffsets[i+1]) */
+	TArray<int32> WeightOffsets;
+	TArray<int32> WeightIndices;
+	TArray<float> WeightValues;
+
+	/** Settings and lattice elements the weights were built with */
+	float WeightThreshold = 0.0f;
+	int32 MaxInfluences = 0;
+	TArray<int32> LatticeElements;
+
+	/** Lattice transforms gathered once per execution */
+	TArray<FTransform> LatticeTransforms;
+	TArray<FTransform> LatticeDeltaTransforms;
 
 	UPROPERTY()
 		TArray<FCachedRigElement> CachedParents;
+
+	UPROPERTY()
+		TArray<FCachedRigElement> CachedLattice;
+
+	UPROPERTY()
+		TArray<FCachedRigElement> CachedChain;
+
+	UPROPERTY()
+		FRigChainWriteBack WriteBack;
+
+	/** Debug primitives recorded during the lattice pass */
+	FRigDebugBuffer DebugBuffer;
 };
 
 /**
@@ -57,6 +81,18 @@ public:
 	UPROPERTY(meta = (Input, ExpandByDefault))
 		TArray<FRigUnit_LatticePoint> Lattice;
 
+	/**
+	 * Lattice influences with weights below this are ignored
+	 */
+	UPROPERTY(meta = (Input, Constant, DetailsOnly))
+		float WeightThreshold = 0.001f;
+
+	/**
+	 * Maximum number of lattice influences per chain element, 0 for unlimited
+	 */
+	UPROPERTY(meta = (Input, Constant, DetailsOnly))
+		int32 MaxInfluences = 0;
+
 	/**
 	 */
 	UPROPERTY(meta = (Input, Constant))
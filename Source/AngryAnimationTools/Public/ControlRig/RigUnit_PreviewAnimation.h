@@ -4,6 +4,7 @@
 
 #include "Units/RigUnit.h"
 #include "ControlRig/Utility.h"
+#include "UObject/StrongObjectPtr.h"
 
 #include "RigUnit_PreviewAnimation.generated.h"
 
@@ -24,6 +25,14 @@ struct FRigUnit_PreviewSettings
 		TSubclassOf<UControlRig> ConversionRigClass;
 };
 
+/** Conversion rig created on the game thread for an evaluation running on a worker thread */
+struct FPreviewConversionRigRequest
+{
+	TSubclassOf<UControlRig> ConversionRigClass;
+	TStrongObjectPtr<UControlRig> ConversionRig;
+	std::atomic<bool> bDone = false;
+};
+
 USTRUCT(BlueprintType)
 struct FRigUnit_PreviewAnimation_WorkData
 {
@@ -40,7 +49,39 @@ struct FRigUnit_PreviewAnimation_WorkData
 		bool bInitialized = false;
 
 	UPROPERTY(transient)
-		TWeakObjectPtr<UControlRig> ConversionRig;
+		TObjectPtr<UControlRig> ConversionRig;
+
+	TSharedPtr<FPreviewConversionRigRequest, ESPMode::ThreadSafe> ConversionRigRequest;
+
+	/** Inputs the cache below was built for */
+	UPROPERTY(transient)
+		TWeakObjectPtr<UAnimSequence> CachedAnimation;
+
+	UPROPERTY(transient)
+		TWeakObjectPtr<USkeleton> CachedSkeleton;
+
+	UPROPERTY(transient)
+		TWeakObjectPtr<UClass> CachedConversionRigClass;
+
+	UPROPERTY(transient)
+		TWeakObjectPtr<UControlRig> CachedConversionRig;
+
+	bool bCachedBake = false;
+	int32 TopologyVersion = INDEX_NONE;
+
+	/** Element index in the target hierarchy (or conversion hierarchy if there is one) for each skeleton bone */
+	TArray<int32> BoneRemap;
+
+	/** Conversion rig controls and the target rig elements they are copied to */
+	TArray<int32> ControlSources;
+	TArray<int32> ControlTargets;
+
+	/** Baked local bone transforms, laid out frame by frame with one entry per skeleton bone */
+	TArray<FVector> BakedTranslations;
+	TArray<FQuat> BakedRotations;
+	TArray<FVector> BakedScales;
+	int32 BakedFrames = 0;
+	double BakedInterval = 0.0;
 
 	struct FBoneContainer BoneContainer;
 	struct FCompactPose Pose;
@@ -50,9 +91,11 @@ struct FRigUnit_PreviewAnimation_WorkData
 
 /**
  * Maps an animation asset to available controls
- * NOTE: This node is super slow, only use for testing retargeting rigs
+ * NOTE: Only use for testing retargeting rigs
+ * NOTE: Not worker thread safe (WorkerThreadUnsafe). A conversion rig can only be created on the game thread,
+ * worker thread evaluations request it there and skip the pose until a later evaluation picks it up
  */
-USTRUCT(meta = (DisplayName = "Preview animation", Category = "Utility", Keywords = "Angry,Preview", PrototypeName = "PreviewAnimation", NodeColor = "1.0 0.44 0.0"))
+USTRUCT(meta = (DisplayName = "Preview animation", Category = "Utility", Keywords = "Angry,Preview", PrototypeName = "PreviewAnimation", NodeColor = "1.0 0.44 0.0", WorkerThreadUnsafe))
 struct ANGRYANIMATIONTOOLS_API FRigUnit_PreviewAnimation : public FRigUnitMutable
 {
 	GENERATED_BODY()
@@ -70,6 +113,18 @@ public:
 	UPROPERTY(meta = (Input, DetailsOnly))
 		FRigUnit_PreviewSettings PreviewSettings;
 
+	/**
+	 * Sample the whole animation once and interpolate between baked frames instead of decompressing every frame
+	 */
+	UPROPERTY(meta = (Input, DetailsOnly))
+		bool bBakePose = false;
+
+	/**
+	 * Memory used by baked frames in bytes
+	 */
+	UPROPERTY(meta = (Output))
+		int32 BakedMemory = 0;
+
 	// Cache
 	UPROPERTY(transient)
 		FRigUnit_PreviewAnimation_WorkData WorkData;
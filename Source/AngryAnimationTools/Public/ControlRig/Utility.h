@@ -0,0 +1,308 @@
+
+
+#pragma once
+#include "Units/RigUnit.h"
+#include "Trace/Trace.h"
+#include "Utility.generated.h"
+
+// Debug drawing is compiled out of shipping builds unless defined otherwise in the build rules
+#ifndef ANGRY_RIGUNIT_DEBUG_DRAW
+#define ANGRY_RIGUNIT_DEBUG_DRAW !UE_BUILD_SHIPPING
+#endif
+
+// Unit traces are compiled out of shipping builds unless defined otherwise in the build rules
+#ifndef ANGRY_RIGUNIT_TRACE
+#define ANGRY_RIGUNIT_TRACE (UE_TRACE_ENABLED && !UE_BUILD_SHIPPING)
+#endif
+
+struct FRigVMDrawInterface;
+struct FControlRigExecuteContext;
+
+#if ANGRY_RIGUNIT_TRACE
+
+UE_TRACE_CHANNEL_EXTERN(AngryRigUnitChannel, ANGRYANIMATIONTOOLS_API)
+
+/**
+ * Per-unit solve counters emitted on the AngryRigUnit trace channel for Unreal Insights.
+ * Only a channel check is done if the channel is off, enable with -trace=AngryRigUnit or Trace.Enable AngryRigUnit.
+ */
+struct ANGRYANIMATIONTOOLS_API FRigUnitTraceScope
+{
+	FORCEINLINE FRigUnitTraceScope(const TCHAR* InName)
+		: Name(InName)
+		, bEnabled(UE_TRACE_CHANNELEXPR_IS_ENABLED(AngryRigUnitChannel))
+	{
+		if (bEnabled)
+		{
+			Begin();
+		}
+	}
+
+	FORCEINLINE ~FRigUnitTraceScope()
+	{
+		if (bEnabled)
+		{
+			End();
+		}
+	}
+
+	/** Scope of the unit currently executing on this thread, null if tracing is off. Check the channel before calling this in hot paths */
+	static FRigUnitTraceScope* GetActive();
+
+	const TCHAR* Name;
+	uint64 StartCycle = 0;
+	int32 Iterations = 0;
+	int32 ChainLength = 0;
+	int32 Writes = 0;
+	int32 Propagations = 0;
+	bool bEnabled;
+
+private:
+	void Begin();
+	void End();
+
+	FRigUnitTraceScope* Previous = nullptr;
+};
+
+#define ANGRY_RIGUNIT_TRACE_SCOPE(Unit) FRigUnitTraceScope RigUnitTraceScope(TEXT(#Unit))
+#define ANGRY_RIGUNIT_TRACE_COUNT(Counter, Value) RigUnitTraceScope.Counter += (Value)
+// Checks the channel inline first, the active scope is only looked up while tracing
+#define ANGRY_RIGUNIT_TRACE_ACTIVE_COUNT(Counter, Value) if (UE_TRACE_CHANNELEXPR_IS_ENABLED(AngryRigUnitChannel)) { if (FRigUnitTraceScope* ActiveTraceScope = FRigUnitTraceScope::GetActive()) { ActiveTraceScope->Counter += (Value); } }
+
+#else
+
+#define ANGRY_RIGUNIT_TRACE_SCOPE(Unit)
+#define ANGRY_RIGUNIT_TRACE_COUNT(Counter, Value)
+#define ANGRY_RIGUNIT_TRACE_ACTIVE_COUNT(Counter, Value)
+
+#endif
+
+/** Hierarchy writes counted towards the trace scope of the executing unit, arguments are the same as the hierarchy's */
+struct FRigTracedWrite
+{
+	template<typename ElementType>
+	static FORCEINLINE void SetGlobalTransform(URigHierarchy* Hierarchy, ElementType&& Element, const FTransform& Transform, bool bInitial, bool bAffectChildren)
+	{
+		Hierarchy->SetGlobalTransform(Forward<ElementType>(Element), Transform, bInitial, bAffectChildren);
+		ANGRY_RIGUNIT_TRACE_ACTIVE_COUNT(Writes, 1);
+		ANGRY_RIGUNIT_TRACE_ACTIVE_COUNT(Propagations, bAffectChildren ? 1 : 0);
+	}
+
+	template<typename ElementType>
+	static FORCEINLINE void SetLocalTransform(URigHierarchy* Hierarchy, ElementType&& Element, const FTransform& Transform, bool bInitial, bool bAffectChildren)
+	{
+		Hierarchy->SetLocalTransform(Forward<ElementType>(Element), Transform, bInitial, bAffectChildren);
+		ANGRY_RIGUNIT_TRACE_ACTIVE_COUNT(Writes, 1);
+		ANGRY_RIGUNIT_TRACE_ACTIVE_COUNT(Propagations, bAffectChildren ? 1 : 0);
+	}
+};
+
+UENUM(BlueprintType)
+enum class EPropagation : uint8
+{
+	/** Don't propagate to children */
+	Off,
+	/** Only propagate to children of the first and last node (fast), children further down the chain keep their offset to the first node */
+	OnlyLast,
+	/** Propagate to all children (slowest) */
+	All
+};
+
+UENUM(BlueprintType)
+enum class EBendScaleType : uint8
+{
+	/** Scale with local transform */
+	Default,
+	/** Don't scale at all */
+	None,
+	/** Stretch towards target */
+	Stretch
+};
+
+UENUM(BlueprintType)
+enum class ESolverQuality : uint8
+{
+	/** Full iteration count and debug drawing */
+	Full,
+	/** Scaled iteration count without debug drawing */
+	Reduced,
+	/** Cheap analytic approximation instead of iterating */
+	Approximate
+};
+
+
+USTRUCT()
+struct FDebugSettings
+{
+	GENERATED_BODY()
+
+	FDebugSettings()
+	{
+		bEnabled = false;
+		Scale = 1.f;
+	}
+
+	/**
+	 * If enabled debug information will be drawn
+	 */
+	UPROPERTY(EditAnywhere, meta = (Input), Category = "DebugSettings")
+		bool bEnabled;
+
+	/**
+	 * The size of the debug drawing information
+	 */
+	UPROPERTY(EditAnywhere, meta = (Input, EditCondition = "bEnabled"), Category = "DebugSettings")
+		float Scale;
+
+	/** Whether debug information should be drawn, always false if debug drawing is compiled out */
+	FORCEINLINE bool IsEnabled() const
+	{
+#if ANGRY_RIGUNIT_DEBUG_DRAW
+		return bEnabled;
+#else
+		return false;
+#endif
+	}
+};
+
+USTRUCT()
+struct ANGRYANIMATIONTOOLS_API FLODSettings
+{
+	GENERATED_BODY()
+
+	/**
+	 * If enabled the LOD is the predicted LOD of the owning skeletal mesh component, otherwise LOD is used
+	 */
+	UPROPERTY(EditAnywhere, meta = (Input), Category = "LODSettings")
+		bool bUseComponentLOD = true;
+
+	/**
+	 * LOD to use if not taken from the component, e.g. driven by a rig variable
+	 */
+	UPROPERTY(EditAnywhere, meta = (Input), Category = "LODSettings")
+		int32 LOD = 0;
+
+	/**
+	 * LOD from which iterations are scaled down and debug drawing is skipped
+	 */
+	UPROPERTY(EditAnywhere, meta = (Input), Category = "LODSettings")
+		int32 ReducedLOD = 2;
+
+	/**
+	 * Iteration scale applied for each LOD from ReducedLOD on
+	 */
+	UPROPERTY(EditAnywhere, meta = (Input, ClampMin = "0", ClampMax = "1"), Category = "LODSettings")
+		float IterationScale = 0.5f;
+
+	/**
+	 * LOD from which the solver uses its analytic approximation, negative to never approximate
+	 */
+	UPROPERTY(EditAnywhere, meta = (Input), Category = "LODSettings")
+		int32 ApproximateLOD = INDEX_NONE;
+
+	/** LOD the rig is currently evaluated at */
+	int32 GetLOD(const FControlRigExecuteContext& ExecuteContext) const;
+
+	ESolverQuality GetQuality(int32 InLOD) const;
+
+	/** Iteration count for given LOD, at least one */
+	int32 ScaleIterations(int32 Iterations, int32 InLOD) const;
+};
+
+/**
+ * Debug primitives recorded during a solve and drawn in one pass afterwards, so solver loops don't need the draw interface.
+ * Recording does nothing if debug drawing is compiled out.
+ */
+struct FRigDebugBuffer
+{
+	struct FPoint
+	{
+		FVector Location;
+		FLinearColor Color;
+		float Size;
+	};
+
+	struct FLine
+	{
+		FVector Start;
+		FVector End;
+		FLinearColor Color;
+		float Thickness;
+	};
+
+	FORCEINLINE void Reset()
+	{
+#if ANGRY_RIGUNIT_DEBUG_DRAW
+		Points.Reset();
+		Lines.Reset();
+#endif
+	}
+
+	FORCEINLINE void AddPoint(const FVector& Location, float Size, const FLinearColor& Color)
+	{
+#if ANGRY_RIGUNIT_DEBUG_DRAW
+		Points.Add({ Location, Color, Size });
+#endif
+	}
+
+	FORCEINLINE void AddLine(const FVector& Start, const FVector& End, float Thickness, const FLinearColor& Color)
+	{
+#if ANGRY_RIGUNIT_DEBUG_DRAW
+		Lines.Add({ Start, End, Color, Thickness });
+#endif
+	}
+
+	/** Draws and clears all recorded primitives */
+	void Flush(FRigVMDrawInterface* DrawInterface);
+
+#if ANGRY_RIGUNIT_DEBUG_DRAW
+	TArray<FPoint> Points;
+	TArray<FLine> Lines;
+#endif
+};
+
+
+/**
+ * Collects new global transforms for a chain and commits them to the hierarchy in one pass.
+ * Chain elements are written without propagation, children branching off the chain are propagated once afterwards.
+ * Chains that skip elements or aren't parented to each other fall back to propagating every write.
+ */
+USTRUCT()
+struct FRigChainWriteBack
+{
+	GENERATED_BODY()
+
+	/** Sizes the transform buffer and resolves the branches of the chain, only does work if the chain or topology changed */
+	void Prepare(const TArray<FCachedRigElement>& Chain, const URigHierarchy* Hierarchy);
+
+	/** Writes all transforms to the hierarchy from root to tip */
+	void Commit(URigHierarchy* Hierarchy, EPropagation Propagation);
+
+	/** Current transform of a chain element relative to the previous one, which is its local transform if it's a direct child */
+	FTransform GetLocalTransform(const URigHierarchy* Hierarchy, int32 Index) const;
+
+	/** Whether every element is a direct child of the previous one */
+	bool IsContinuous() const { return bContinuous; }
+
+	/** New global transform for each chain element */
+	TArray<FTransform> Transforms;
+
+	/** Hierarchy index of each chain element */
+	TArray<int32> Elements;
+
+	/** Children of chain elements that are not part of the chain, ordered from root to tip */
+	TArray<int32> Branches;
+
+	/** Cumulative branch count for each chain element */
+	TArray<int32> BranchOffsets;
+
+	/** Local transforms of the branches, restored after the chain was written. Relative to the chain root for branches below it with OnlyLast */
+	TArray<FTransform> BranchLocals;
+
+	/** Whether each element is a direct child of the previous one, the root always is */
+	TArray<bool> Links;
+
+	bool bContinuous = true;
+
+	int32 TopologyVersion = INDEX_NONE;
+};
@@ -34,7 +34,10 @@ public class AngryAnimationToolsEditor : ModuleRules
                 "LevelSequenceEditor",
                 "EditorStyle",
                 "AnimationEditor",
-                "UnrealEd"
+                "UnrealEd",
+                "RigVM",
+                "AnimGraphRuntime",
+                "AngryAnimationTools"
             }
 			);
 	}
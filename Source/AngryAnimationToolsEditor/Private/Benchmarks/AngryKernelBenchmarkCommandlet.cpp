@@ -0,0 +1,935 @@
+
+
+#include "Benchmarks/AngryKernelBenchmarkCommandlet.h"
+#include "ControlRig/RigUnit_Ellipsoid.h"
+#include "ControlRig/RigUnit_Constraints.h"
+#include "ControlRig/IK/RigUnit_HingeIK.h"
+#include "ControlRig/IK/RigUnit_ConeFABRIK.h"
+#include "ControlRig/IK/RigUnit_SpineIK.h"
+#include "ControlRig/IK/RigUnit_BSplineIK.h"
+#include "ControlRig/IK/RigUnit_SplineIK.h"
+#include "ControlRig/IK/RigUnit_ArmIK.h"
+#include "ControlRig/IK/RigUnit_ClavicleIK.h"
+#include "ControlRig/IK/RigUnit_DigitigradeIK.h"
+#include "ControlRig/RigUnit_Analysis.h"
+#include "ControlRig/RigUnit_Lattice.h"
+#include "ControlRig/RigUnit_PreviewAnimation.h"
+
+#include "Animation/AnimSequence.h"
+#include "Animation/AnimData/IAnimationDataController.h"
+#include "Rigs/RigHierarchyController.h"
+#include "Rigs/FKControlRig.h"
+#include "UObject/StrongObjectPtr.h"
+
+#include "Async/Async.h"
+#include "Async/ParallelFor.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogAngryKernelBenchmark, Log, All);
+
+// Forwards to the actual allocator, only allocations of the thread that is currently timing a benchmark are counted
+struct FBenchmarkMallocCounter : public FMalloc
+{
+	FBenchmarkMallocCounter(FMalloc* InInner) : Inner(InInner) {}
+
+	// Installed once and never removed, so calls other threads already made through either allocator stay valid
+	static void Install()
+	{
+		check(IsInGameThread());
+		static FBenchmarkMallocCounter* Counter = nullptr;
+		if (!Counter)
+		{
+			Counter = new FBenchmarkMallocCounter(GMalloc);
+			GMalloc = Counter;
+		}
+	}
+
+	virtual void* Malloc(SIZE_T Count, uint32 Alignment) override { Allocations += bCounting; return Inner->Malloc(Count, Alignment); }
+	virtual void* Realloc(void* Original, SIZE_T Count, uint32 Alignment) override { Allocations += bCounting; return Inner->Realloc(Original, Count, Alignment); }
+	virtual void Free(void* Original) override { Inner->Free(Original); }
+	virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override { return Inner->GetAllocationSize(Original, SizeOut); }
+	virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override { return Inner->QuantizeSize(Count, Alignment); }
+	virtual bool IsInternallyThreadSafe() const override { return Inner->IsInternallyThreadSafe(); }
+	virtual const TCHAR* GetDescriptiveName() override { return TEXT("BenchmarkMallocCounter"); }
+
+	FMalloc* Inner;
+
+	static thread_local bool bCounting;
+	static thread_local int64 Allocations;
+};
+
+thread_local bool FBenchmarkMallocCounter::bCounting = false;
+thread_local int64 FBenchmarkMallocCounter::Allocations = 0;
+
+// Results are accumulated here so the kernels don't get optimised away
+static volatile double BenchmarkSink = 0.0;
+
+FORCENOINLINE void ConsumeBenchmarkResult(double Value)
+{
+	BenchmarkSink = BenchmarkSink + Value;
+}
+
+template<typename FunctionType>
+void RunKernelBenchmark(const TCHAR* Name, int32 Size, int32 Iterations, FunctionType&& Function)
+{
+	// Warm up caches and lazily grown buffers
+	const int32 WarmupNum = FMath::Min(Iterations, 100);
+	for (int32 Iteration = 0; Iteration < WarmupNum; Iteration++)
+	{
+		Function(Iteration);
+	}
+
+	FBenchmarkMallocCounter::Install();
+	FBenchmarkMallocCounter::Allocations = 0;
+	FBenchmarkMallocCounter::bCounting = true;
+
+	const double Start = FPlatformTime::Seconds();
+	for (int32 Iteration = 0; Iteration < Iterations; Iteration++)
+	{
+		Function(Iteration);
+	}
+	const double Seconds = FPlatformTime::Seconds() - Start;
+
+	FBenchmarkMallocCounter::bCounting = false;
+
+	const double Nanoseconds = Seconds * 1.0e9 / Iterations;
+	const double Allocations = ((double)FBenchmarkMallocCounter::Allocations) / Iterations;
+	UE_LOG(LogAngryKernelBenchmark, Display, TEXT("%-28s %6d %12.1f ns/op %10.3f allocs/op"), Name, Size, Nanoseconds, Allocations);
+}
+
+FTransform RandomBenchmarkTransform(FRandomStream& Random, float Extent)
+{
+	const FQuat Rotation = FQuat(Random.GetUnitVector(), Random.FRandRange(-PI, PI));
+	const FVector Location = Random.GetUnitVector() * Random.FRandRange(0.0f, Extent);
+	const FVector Scale = FVector(Random.FRandRange(0.5f, 2.0f), Random.FRandRange(0.5f, 2.0f), Random.FRandRange(0.5f, 2.0f));
+	return FTransform(Rotation, Location, Scale);
+}
+
+// Closest point on an ellipsoid by bisecting the closest point equation to double precision
+FVector ComputeReferenceEllipsoidProjection(const FTransform& Transform, float Radius, const FVector& Point)
+{
+	const FVector Axes = Transform.GetScale3D().GetAbs() * Radius;
+	const FVector Axes2 = Axes * Axes;
+	const FVector Local = Transform.InverseTransformPositionNoScale(Point);
+	const FVector Weighted = Axes * Local;
+
+	// Root of |e y / (t + e^2)|^2 - 1 lies between these bounds
+	double Lower = FMath::Max((Weighted.GetAbs() - Axes2).GetMax(), -Axes2.GetMin());
+	double Upper = Axes.GetMax() * Local.Size();
+	for (int32 Iteration = 0; Iteration < 256 && Lower < Upper; Iteration++)
+	{
+		const double Param = (Lower + Upper) * 0.5;
+		const FVector Ratio = Weighted / (Axes2 + FVector(Param));
+		if (Ratio.SizeSquared() > 1.0)
+		{
+			Lower = Param;
+		}
+		else
+		{
+			Upper = Param;
+		}
+	}
+
+	return Transform.TransformPositionNoScale(Axes2 * Local / (Axes2 + FVector((Lower + Upper) * 0.5)));
+}
+
+// Logs mean and max distance of each projection mode to the reference closest point
+void ReportProjectionAccuracy(const TArray<FTransform>& Transforms, const TArray<FVector>& Points)
+{
+	UE_LOG(LogAngryKernelBenchmark, Display, TEXT("%-28s %15s %15s"), TEXT("Projection"), TEXT("Mean error"), TEXT("Max error"));
+
+	auto Report = [&](const TCHAR* Name, EEllipsoidProjectionMode Mode, int32 Iterations)
+	{
+		double Sum = 0.0;
+		double Max = 0.0;
+		for (int32 Index = 0; Index < Points.Num(); Index++)
+		{
+			FVector Closest, Normal;
+			FRigUnit_EllipsoidProjection::ComputeEllispoidProjection(Mode, Iterations, Transforms[Index], 100.0f, Points[Index], Closest, Normal);
+
+			const double Error = (Closest - ComputeReferenceEllipsoidProjection(Transforms[Index], 100.0f, Points[Index])).Size();
+			Sum += Error;
+			Max = FMath::Max(Max, Error);
+		}
+		UE_LOG(LogAngryKernelBenchmark, Display, TEXT("%-28s %15.4f %15.4f"), Name, Sum / Points.Num(), Max);
+	};
+
+	Report(TEXT("Raycast"), EEllipsoidProjectionMode::Raycast, 0);
+	Report(TEXT("Newton 2"), EEllipsoidProjectionMode::Newton, 2);
+	Report(TEXT("Newton 4"), EEllipsoidProjectionMode::Newton, 4);
+	Report(TEXT("Newton 8"), EEllipsoidProjectionMode::Newton, 8);
+	Report(TEXT("Approximate"), EEllipsoidProjectionMode::Approximate, 0);
+}
+
+// Transient skeleton and sequence so Preview Animation can be stressed without any content, bones swing around their up axis
+UAnimSequence* CreateSyntheticPreviewAnimation(int32 BoneNum, int32 FrameNum)
+{
+	check(IsInGameThread());
+	USkeleton* Skeleton = NewObject<USkeleton>(GetTransientPackage());
+	{
+		FReferenceSkeletonModifier Modifier(Skeleton);
+		for (int32 BoneIndex = 0; BoneIndex < BoneNum; BoneIndex++)
+		{
+			const FName Name = *FString::Printf(TEXT("preview_%d"), BoneIndex);
+			Modifier.Add(FMeshBoneInfo(Name, Name.ToString(), BoneIndex - 1), FTransform(FVector(10.0f, 0.0f, 0.0f)));
+		}
+	}
+
+	UAnimSequence* Sequence = NewObject<UAnimSequence>(GetTransientPackage());
+	Sequence->SetSkeleton(Skeleton);
+
+	IAnimationDataController& Controller = Sequence->GetController();
+	Controller.InitializeModel();
+	Controller.OpenBracket(FText::FromString(TEXT("Synthetic preview animation")), false);
+	Controller.SetFrameRate(FFrameRate(30, 1), false);
+	Controller.SetNumberOfFrames(FFrameNumber(FrameNum - 1), false);
+
+	TArray<FVector3f> Positions, Scales;
+	TArray<FQuat4f> Rotations;
+	for (int32 BoneIndex = 0; BoneIndex < BoneNum; BoneIndex++)
+	{
+		Positions.Reset();
+		Rotations.Reset();
+		Scales.Reset();
+		for (int32 Frame = 0; Frame < FrameNum; Frame++)
+		{
+			const float Angle = FMath::Sin(2.0f * PI * Frame / FMath::Max(FrameNum - 1, 1) + BoneIndex) * 0.3f;
+			Positions.Emplace(10.0f, 0.0f, 0.0f);
+			Rotations.Emplace(FVector3f::UpVector, Angle);
+			Scales.Emplace(FVector3f::OneVector);
+		}
+
+		const FName Name = *FString::Printf(TEXT("preview_%d"), BoneIndex);
+		Controller.AddBoneCurve(Name, false);
+		Controller.SetBoneTrackKeys(Name, Positions, Rotations, Scales, false);
+	}
+
+	Controller.NotifyPopulated();
+	Controller.CloseBracket(false);
+
+	// Sampling reads compressed data
+	Sequence->CacheDerivedDataForCurrentPlatform();
+	return Sequence;
+}
+
+// Rig instance outside of a control rig, elements are added through the hierarchy controller
+struct FBenchmarkRig
+{
+	void Build(int32 ChainNum, int32 RingNum, int32 InSeed, UAnimSequence* PreviewAnimation);
+
+	// Resets the pose and moves lattice and ellipsoids like animated controls would
+	void Animate(int32 Frame);
+
+	// Appends global transforms of all solved bones
+	void Capture(TArray<float>& Results) const;
+
+	TStrongObjectPtr<URigHierarchy> Hierarchy;
+	FControlRigExecuteContext ExecuteContext;
+
+	TArray<FRigElementKey> Chain;
+	TArray<FRigElementKey> Ring;
+	TArray<FRigElementKey> Lattice;
+	TArray<FRigElementKey> Ellipsoids;
+	TArray<FRigElementKey> PreviewBones;
+	int32 Seed = 0;
+};
+
+void FBenchmarkRig::Build(int32 ChainNum, int32 RingNum, int32 InSeed, UAnimSequence* PreviewAnimation)
+{
+	check(IsInGameThread());
+	Seed = InSeed;
+	FRandomStream Random(Seed);
+
+	Hierarchy.Reset(NewObject<URigHierarchy>(GetTransientPackage()));
+	URigHierarchyController* Controller = Hierarchy->GetController(true);
+
+	const FRigElementKey Root = Controller->AddBone(TEXT("stress_root"), FRigElementKey(), FTransform::Identity, true, ERigBoneType::User, false);
+
+	// Slightly bent strand along X
+	FRigElementKey Parent = Root;
+	for (int32 Index = 0; Index < ChainNum; Index++)
+	{
+		const FTransform Local(FQuat(FVector::UpVector, Random.FRandRange(-0.2f, 0.2f)), FVector(10.0f, 0.0f, 0.0f));
+		Parent = Controller->AddBone(*FString::Printf(TEXT("stress_chain_%d"), Index), Parent, Local, false, ERigBoneType::User, false);
+		Chain.Emplace(Parent);
+	}
+
+	// Ring around the root, cast downwards onto the ellipsoids
+	for (int32 Index = 0; Index < RingNum; Index++)
+	{
+		const float Angle = 2.0f * PI * Index / RingNum;
+		const FTransform Local(FVector(FMath::Cos(Angle), FMath::Sin(Angle), 0.0f) * 30.0f + FVector(0.0f, 0.0f, 15.0f));
+		Ring.Emplace(Controller->AddBone(*FString::Printf(TEXT("stress_ring_%d"), Index), Root, Local, false, ERigBoneType::User, false));
+	}
+
+	for (int32 Index = 0; Index < 4; Index++)
+	{
+		const FTransform Local(FVector(Index * ChainNum * 10.0f / 3.0f, 0.0f, 0.0f));
+		Lattice.Emplace(Controller->AddNull(*FString::Printf(TEXT("stress_lattice_%d"), Index), Root, Local, false, false));
+	}
+
+	for (int32 Index = 0; Index < 2; Index++)
+	{
+		const FTransform Local(FQuat::Identity, FVector(Index * ChainNum * 5.0f, 0.0f, 0.0f), FVector(Random.FRandRange(0.5f, 1.5f), Random.FRandRange(0.5f, 1.5f), 0.5f));
+		Ellipsoids.Emplace(Controller->AddNull(*FString::Printf(TEXT("stress_ellipsoid_%d"), Index), Root, Local, false, false));
+	}
+
+	// Preview animation bones are matched by name, so they mirror the skeleton
+	if (PreviewAnimation && PreviewAnimation->GetSkeleton())
+	{
+		const FReferenceSkeleton& Reference = PreviewAnimation->GetSkeleton()->GetReferenceSkeleton();
+		for (int32 BoneIndex = 0; BoneIndex < Reference.GetNum(); BoneIndex++)
+		{
+			const int32 ParentIndex = Reference.GetParentIndex(BoneIndex);
+			const FRigElementKey BoneParent = ParentIndex != INDEX_NONE ? PreviewBones[ParentIndex] : FRigElementKey();
+			PreviewBones.Emplace(Controller->AddBone(Reference.GetBoneName(BoneIndex), BoneParent, Reference.GetRefBonePose()[BoneIndex], false, ERigBoneType::User, false));
+		}
+	}
+
+	ExecuteContext.Hierarchy = Hierarchy.Get();
+	ExecuteContext.SetDeltaTime(1.0f / 60.0f);
+}
+
+void FBenchmarkRig::Animate(int32 Frame)
+{
+	Hierarchy->ResetPoseToInitial(ERigElementType::All);
+
+	const float Time = Frame / 60.0f;
+	for (int32 Index = 0; Index < Lattice.Num(); Index++)
+	{
+		const FVector Offset = FVector(0.0f, FMath::Sin(Time * 3.0f + Index + Seed), FMath::Cos(Time * 2.0f + Index)) * 5.0f;
+		Hierarchy->SetLocalTransform(Lattice[Index], FTransform(Hierarchy->GetLocalTransform(Lattice[Index]).GetLocation() + Offset), false, true);
+	}
+
+	for (int32 Index = 0; Index < Ellipsoids.Num(); Index++)
+	{
+		FTransform Transform = Hierarchy->GetLocalTransform(Ellipsoids[Index]);
+		Transform.AddToTranslation(FVector(0.0f, 0.0f, FMath::Sin(Time * 4.0f + Index + Seed) * 20.0f));
+		Hierarchy->SetLocalTransform(Ellipsoids[Index], Transform, false, true);
+	}
+}
+
+void FBenchmarkRig::Capture(TArray<float>& Results) const
+{
+	auto Append = [&](const TArray<FRigElementKey>& Keys)
+	{
+		for (const FRigElementKey& Key : Keys)
+		{
+			const FTransform Transform = Hierarchy->GetGlobalTransform(Key);
+			const FVector Location = Transform.GetLocation();
+			const FQuat Rotation = Transform.GetRotation();
+			Results.Append({ (float)Location.X, (float)Location.Y, (float)Location.Z, (float)Rotation.X, (float)Rotation.Y, (float)Rotation.Z, (float)Rotation.W });
+		}
+	};
+
+	Append(Chain);
+	Append(Ring);
+	Append(PreviewBones);
+}
+
+template<typename UnitType>
+FORCEINLINE void ExecuteBenchmarkUnit(UnitType& Unit, FControlRigExecuteContext& ExecuteContext)
+{
+	Unit.Execute(ExecuteContext);
+}
+
+// Units of one rig instance, each keeps its own work data across frames
+struct FBenchmarkRigUnits
+{
+	void Setup(const FBenchmarkRig& Rig, UAnimSequence* PreviewAnimation, TSubclassOf<UControlRig> ConversionRigClass = nullptr);
+	void Execute(FBenchmarkRig& Rig, int32 Frame);
+
+	FRigUnit_EllipsoidColliderSet ColliderSet;
+	FRigUnit_SpineIK SpineIK;
+	FRigUnit_LatticeTransform LatticeTransform;
+	FRigUnit_EllipsoidLineCollideMulti LineCollide;
+	FRigUnit_EllipsoidRingCast RingCast;
+	FRigUnit_PreviewAnimation PreviewAnimation;
+	bool bPreviewAnimation = false;
+
+	// Only benchmarked on their own, they would fight over the chain within one rig evaluation
+	FRigUnit_ConeFABRIK ConeFABRIK;
+	FRigUnit_BSplineIK BSplineIK;
+	FRigUnit_SplineIK SplineIK;
+	FRigUnit_EllipsoidChainCollide ChainCollide;
+	FRigUnit_PowerDirection PowerDirection;
+
+	// Limbs use the start of the chain, they are left empty if it is too short
+	FRigUnit_HingeIK HingeIK;
+	FRigUnit_ArmIK ArmIK;
+	FRigUnit_ClaviceIK ClavicleIK;
+	FRigUnit_DigitigradeIK DigitigradeIK;
+};
+
+void FBenchmarkRigUnits::Setup(const FBenchmarkRig& Rig, UAnimSequence* InPreviewAnimation, TSubclassOf<UControlRig> ConversionRigClass)
+{
+	for (const FRigElementKey& Key : Rig.Ellipsoids)
+	{
+		FEllipsoid Ellipsoid;
+		Ellipsoid.Key = Key;
+		Ellipsoid.Radius = 20.0f;
+		ColliderSet.Ellipsoids.Emplace(Ellipsoid);
+		RingCast.Ellipsoids.Emplace(Ellipsoid);
+	}
+
+	SpineIK.Chain = FRigElementKeyCollection(Rig.Chain);
+	SpineIK.Iterations = 4;
+
+	LatticeTransform.Chain = FRigElementKeyCollection(Rig.Chain);
+	for (const FRigElementKey& Key : Rig.Lattice)
+	{
+		FRigUnit_LatticePoint Point;
+		Point.Key = Key;
+		Point.Distribution = FVector(Rig.Chain.Num() * 10.0f / 3.0f);
+		LatticeTransform.Lattice.Emplace(Point);
+	}
+
+	// Strand of segments, each pivot's tip is the next pivot
+	TArray<FRigElementKey> Pivots(Rig.Chain.GetData(), Rig.Chain.Num() - 1);
+	TArray<FRigElementKey> Tips(Rig.Chain.GetData() + 1, Rig.Chain.Num() - 1);
+	LineCollide.Pivots = FRigElementKeyCollection(Pivots);
+	LineCollide.Tips = FRigElementKeyCollection(Tips);
+	LineCollide.Direction = FVector::UpVector;
+
+	RingCast.Items = FRigElementKeyCollection(Rig.Ring);
+	RingCast.CastAxis = FVector(0.0f, 0.0f, 1.0f);
+	RingCast.CastDistance = 60.0f;
+
+	bPreviewAnimation = InPreviewAnimation != nullptr;
+	PreviewAnimation.PreviewSettings.PreviewAnimation = InPreviewAnimation;
+	PreviewAnimation.PreviewSettings.ConversionRigClass = ConversionRigClass;
+
+	const FRigElementKeyCollection Chain(Rig.Chain);
+	ConeFABRIK.Chain = Chain;
+	BSplineIK.Chain = Chain;
+	SplineIK.Chain = Chain;
+	ChainCollide.Chain = Chain;
+	ChainCollide.Ellipsoids = ColliderSet.Ellipsoids;
+	PowerDirection.Chain = Chain;
+
+	// Two controls bending the strand sideways
+	const float Length = Rig.Chain.Num() * 10.0f;
+	SplineIK.Controls.Emplace(FVector(Length / 3.0f, Length * 0.2f, 0.0f));
+	SplineIK.Controls.Emplace(FVector(Length * 2.0f / 3.0f, Length * -0.2f, 0.0f));
+
+	if (Rig.Chain.Num() >= 3)
+	{
+		const FRigElementKeyCollection Limb(TArray<FRigElementKey>(Rig.Chain.GetData(), 3));
+		HingeIK.Chain = Limb;
+		HingeIK.Direction = FVector::UpVector;
+		ArmIK.Chain = Limb;
+	}
+
+	if (Rig.Chain.Num() >= 4)
+	{
+		const FRigElementKeyCollection Limb(TArray<FRigElementKey>(Rig.Chain.GetData(), 4));
+		ClavicleIK.Chain = Limb;
+		DigitigradeIK.Chain = Limb;
+	}
+}
+
+void FBenchmarkRigUnits::Execute(FBenchmarkRig& Rig, int32 Frame)
+{
+	Rig.Animate(Frame);
+
+	FControlRigExecuteContext& ExecuteContext = Rig.ExecuteContext;
+	if (bPreviewAnimation)
+	{
+		ExecuteBenchmarkUnit(PreviewAnimation, ExecuteContext);
+	}
+
+	ExecuteBenchmarkUnit(ColliderSet, ExecuteContext);
+	LineCollide.ColliderSet = ColliderSet.ColliderSet;
+
+	const FVector Tip = Rig.Hierarchy->GetGlobalTransform(Rig.Chain.Last()).GetLocation();
+	SpineIK.Objective = FTransform(Tip + FVector(0.0f, FMath::Sin(Frame * 0.1f), FMath::Cos(Frame * 0.07f)) * Rig.Chain.Num() * 2.0f);
+
+	ExecuteBenchmarkUnit(SpineIK, ExecuteContext);
+	ExecuteBenchmarkUnit(LatticeTransform, ExecuteContext);
+	ExecuteBenchmarkUnit(LineCollide, ExecuteContext);
+	ExecuteBenchmarkUnit(RingCast, ExecuteContext);
+}
+
+// Executes the units of every rig instance on its own hierarchy for a few frames, returns the pose after every frame per instance
+// Frames run off the game thread like animation evaluation, so units handing work to the game thread behave the same in serial and parallel runs
+TArray<TArray<float>> EvaluateStressInstances(TArray<FBenchmarkRig>& Rigs, UAnimSequence* PreviewAnimation, TSubclassOf<UControlRig> ConversionRigClass, int32 Frames, bool bParallel, int32& Unresolved)
+{
+	const int32 InstanceNum = Rigs.Num();
+
+	// Fresh units so every evaluation starts from empty work data
+	TArray<TUniquePtr<FBenchmarkRigUnits>> Units;
+	for (int32 Instance = 0; Instance < InstanceNum; Instance++)
+	{
+		Units.Emplace(MakeUnique<FBenchmarkRigUnits>());
+		Units.Last()->Setup(Rigs[Instance], PreviewAnimation, ConversionRigClass);
+	}
+
+	TArray<TArray<float>> Results;
+	Results.SetNum(InstanceNum);
+	for (int32 Frame = 0; Frame < Frames; Frame++)
+	{
+		auto ExecuteInstance = [&](int32 Instance)
+		{
+			Units[Instance]->Execute(Rigs[Instance], Frame);
+			Rigs[Instance].Capture(Results[Instance]);
+		};
+
+		// ParallelFor also runs work on the calling thread, so it can't be the game thread either
+		Async(EAsyncExecution::ThreadPool, [&]()
+		{
+			if (bParallel)
+			{
+				ParallelFor(InstanceNum, ExecuteInstance);
+			}
+			else
+			{
+				for (int32 Instance = 0; Instance < InstanceNum; Instance++)
+				{
+					ExecuteInstance(Instance);
+				}
+			}
+		}).Wait();
+
+		// Conversion rigs requested during this frame are created here and picked up by the next one
+		FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+	}
+
+	if (*ConversionRigClass)
+	{
+		for (int32 Instance = 0; Instance < InstanceNum; Instance++)
+		{
+			if (!IsValid(Units[Instance]->PreviewAnimation.WorkData.ConversionRig))
+			{
+				UE_LOG(LogAngryKernelBenchmark, Error, TEXT("Instance %d never picked up its conversion rig"), Instance);
+				Unresolved++;
+			}
+		}
+	}
+	return Results;
+}
+
+// Evaluates many rig instances across the task graph and compares against serial evaluation, returns the number of mismatches
+int32 RunParallelStress(int32 InstanceNum, int32 Rounds, int32 Seed, UAnimSequence* PreviewAnimation, TSubclassOf<UControlRig> ConversionRigClass)
+{
+	constexpr int32 Frames = 8;
+
+	// UObjects are created up front on the game thread, evaluation only touches per-instance data
+	TArray<FBenchmarkRig> Rigs;
+	Rigs.SetNum(InstanceNum);
+	for (int32 Instance = 0; Instance < InstanceNum; Instance++)
+	{
+		Rigs[Instance].Build(16 + Instance % 16, 16 + Instance % 48, Seed + Instance, PreviewAnimation);
+	}
+
+	int32 Mismatches = 0;
+	const TArray<TArray<float>> Serial = EvaluateStressInstances(Rigs, PreviewAnimation, ConversionRigClass, Frames, false, Mismatches);
+
+	for (int32 Round = 0; Round < Rounds; Round++)
+	{
+		const TArray<TArray<float>> Parallel = EvaluateStressInstances(Rigs, PreviewAnimation, ConversionRigClass, Frames, true, Mismatches);
+
+		for (int32 Instance = 0; Instance < InstanceNum; Instance++)
+		{
+			const TArray<float>& Expected = Serial[Instance];
+			const TArray<float>& Actual = Parallel[Instance];
+			if (Expected.Num() != Actual.Num() || FMemory::Memcmp(Expected.GetData(), Actual.GetData(), Expected.Num() * sizeof(float)) != 0)
+			{
+				UE_LOG(LogAngryKernelBenchmark, Error, TEXT("Instance %d differs from serial evaluation in round %d"), Instance, Round);
+				Mismatches++;
+			}
+		}
+	}
+
+	const FString ConversionRigName = *ConversionRigClass ? ConversionRigClass->GetName() : FString(TEXT("none"));
+	UE_LOG(LogAngryKernelBenchmark, Display, TEXT("Parallel stress: %d instances, %d rounds, conversion rig %s, %d mismatches"), InstanceNum, Rounds, *ConversionRigName, Mismatches);
+	return Mismatches;
+}
+
+UAngryKernelBenchmarkCommandlet::UAngryKernelBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UAngryKernelBenchmarkCommandlet::Main(const FString& Params)
+{
+	int32 Iterations = 100000;
+	int32 Seed = 0;
+	FParse::Value(*Params, TEXT("Iterations="), Iterations);
+	FParse::Value(*Params, TEXT("Seed="), Seed);
+	Iterations = FMath::Max(Iterations, 1);
+
+	TArray<int32> Sizes = { 1, 2, 4, 8, 16, 32, 64, 128 };
+	FString SizesParam;
+	if (FParse::Value(*Params, TEXT("Sizes="), SizesParam))
+	{
+		TArray<FString> SizeStrings;
+		SizesParam.ParseIntoArray(SizeStrings, TEXT(","));
+
+		Sizes.Reset();
+		for (const FString& SizeString : SizeStrings)
+		{
+			Sizes.Emplace(FMath::Max(FCString::Atoi(*SizeString), 1));
+		}
+	}
+
+	if (FParse::Param(*Params, TEXT("Stress")))
+	{
+		int32 Instances = 512;
+		int32 Rounds = 8;
+		FParse::Value(*Params, TEXT("Instances="), Instances);
+		FParse::Value(*Params, TEXT("Rounds="), Rounds);
+
+		Instances = FMath::Max(Instances, 1);
+		Rounds = FMath::Max(Rounds, 1);
+
+		// Preview Animation samples the given asset, or a synthetic sequence if there is none
+		TStrongObjectPtr<UAnimSequence> PreviewAnimation;
+		FString PreviewAnimationPath;
+		if (FParse::Value(*Params, TEXT("PreviewAnimation="), PreviewAnimationPath))
+		{
+			PreviewAnimation.Reset(LoadObject<UAnimSequence>(nullptr, *PreviewAnimationPath));
+			if (!PreviewAnimation.IsValid())
+			{
+				UE_LOG(LogAngryKernelBenchmark, Error, TEXT("Could not load preview animation '%s'"), *PreviewAnimationPath);
+				return 1;
+			}
+		}
+		else
+		{
+			PreviewAnimation.Reset(CreateSyntheticPreviewAnimation(8, 31));
+		}
+
+		// Conversion rigs are handed over from the game thread, the FK rig doesn't need any content
+		TSubclassOf<UControlRig> ConversionRigClass = UFKControlRig::StaticClass();
+		FString ConversionRigPath;
+		if (FParse::Value(*Params, TEXT("ConversionRig="), ConversionRigPath))
+		{
+			ConversionRigClass = LoadClass<UControlRig>(nullptr, *ConversionRigPath);
+			if (!*ConversionRigClass)
+			{
+				UE_LOG(LogAngryKernelBenchmark, Error, TEXT("Could not load conversion rig class '%s'"), *ConversionRigPath);
+				return 1;
+			}
+		}
+
+		int32 Mismatches = RunParallelStress(Instances, Rounds, Seed, PreviewAnimation.Get(), nullptr);
+		Mismatches += RunParallelStress(Instances, Rounds, Seed, PreviewAnimation.Get(), ConversionRigClass);
+		return Mismatches > 0 ? 1 : 0;
+	}
+
+	// Pool of random inputs so every iteration sees different data
+	constexpr int32 PoolNum = 1024;
+	FRandomStream Random(Seed);
+
+	TArray<FTransform> Transforms;
+	TArray<FVector> Points, Ends;
+	TArray<FQuat> Rotations;
+	TArray<float> Values;
+	for (int32 Index = 0; Index < PoolNum; Index++)
+	{
+		Transforms.Emplace(RandomBenchmarkTransform(Random, 100.0f));
+		Points.Emplace(Random.GetUnitVector() * Random.FRandRange(0.0f, 300.0f));
+		Ends.Emplace(Random.GetUnitVector() * Random.FRandRange(0.0f, 300.0f));
+		Rotations.Emplace(FQuat(Random.GetUnitVector(), Random.FRandRange(-PI, PI)));
+		Values.Emplace(Random.FRandRange(0.0f, 2.0f * PI));
+	}
+
+	UE_LOG(LogAngryKernelBenchmark, Display, TEXT("%-28s %6s %15s %20s"), TEXT("Kernel"), TEXT("Size"), TEXT("Time"), TEXT("Allocations"));
+
+	/// //////////////////////
+
+	RunKernelBenchmark(TEXT("EllipsoidProjection"), 1, Iterations, [&](int32 Iteration)
+	{
+		const int32 Index = Iteration % PoolNum;
+		FVector Closest, Normal;
+		FRigUnit_EllipsoidProjection::ComputeEllispoidProjection(Transforms[Index], 100.0f, Points[Index], Closest, Normal);
+		ConsumeBenchmarkResult(Closest.X);
+	});
+
+	RunKernelBenchmark(TEXT("EllipsoidProjectionNewton"), 4, Iterations, [&](int32 Iteration)
+	{
+		const int32 Index = Iteration % PoolNum;
+		FVector Closest, Normal;
+		FRigUnit_EllipsoidProjection::ComputeEllispoidProjectionNewton(Transforms[Index], 100.0f, Points[Index], 4, Closest, Normal);
+		ConsumeBenchmarkResult(Closest.X);
+	});
+
+	RunKernelBenchmark(TEXT("EllipsoidProjectionApprox"), 1, Iterations, [&](int32 Iteration)
+	{
+		const int32 Index = Iteration % PoolNum;
+		FVector Closest, Normal;
+		FRigUnit_EllipsoidProjection::ComputeEllispoidProjectionApproximate(Transforms[Index], 100.0f, Points[Index], Closest, Normal);
+		ConsumeBenchmarkResult(Closest.X);
+	});
+
+	RunKernelBenchmark(TEXT("EllipsoidRaycast"), 1, Iterations, [&](int32 Iteration)
+	{
+		const int32 Index = Iteration % PoolNum;
+		float Distance;
+		FVector Impact, Normal;
+		ConsumeBenchmarkResult(FRigUnit_EllipsoidRaycast::ComputeEllispoidRaycast(Transforms[Index], 100.0f, Points[Index], Ends[Index], Impact, Normal, Distance));
+	});
+
+	RunKernelBenchmark(TEXT("HingeTriangle"), 1, Iterations, [&](int32 Iteration)
+	{
+		const int32 Index = Iteration % PoolNum;
+		float h, x;
+		FRigUnit_HingeIK::ComputeTriangle(50.0f, 50.0f, Values[Index] * 15.0f, h, x);
+		ConsumeBenchmarkResult(h);
+	});
+
+	RunKernelBenchmark(TEXT("LimitRotation"), 1, Iterations, [&](int32 Iteration)
+	{
+		const int32 Index = Iteration % PoolNum;
+		ConsumeBenchmarkResult(FRigUnit_LimitRotation::LimitRotation(Rotations[Index], 0.5f, true).W);
+	});
+
+	RunKernelBenchmark(TEXT("SoftLimit"), 1, Iterations, [&](int32 Iteration)
+	{
+		const int32 Index = Iteration % PoolNum;
+		ConsumeBenchmarkResult(FRigUnit_SoftLimitValue::SoftLimit(Values[Index], 1.0f));
+	});
+
+	/// //////////////////////
+
+	// Scaling with the number of ellipsoids per ray
+	for (const int32 Size : Sizes)
+	{
+		const int32 OpIterations = FMath::Max(Iterations / Size, 1);
+
+		RunKernelBenchmark(TEXT("EllipsoidRaycastLoop"), Size, OpIterations, [&](int32 Iteration)
+		{
+			const int32 Index = Iteration % PoolNum;
+			float Time = 1.0f;
+			for (int32 Ellipsoid = 0; Ellipsoid < Size; Ellipsoid++)
+			{
+				float Distance;
+				FVector Impact, Normal;
+				const float CurrTime = FRigUnit_EllipsoidRaycast::ComputeEllispoidRaycast(Transforms[(Index + Ellipsoid) % PoolNum], 100.0f, Points[Index], Ends[Index], Impact, Normal, Distance);
+				if (Distance < 0.01f && CurrTime < Time)
+				{
+					Time = CurrTime;
+				}
+			}
+			ConsumeBenchmarkResult(Time);
+		});
+
+		FEllipsoidBatch Batch;
+		Batch.Reset(Size);
+		for (int32 Ellipsoid = 0; Ellipsoid < Size; Ellipsoid++)
+		{
+			Batch.Set(Ellipsoid, Transforms[Ellipsoid % PoolNum], 100.0f);
+		}
+
+		RunKernelBenchmark(TEXT("EllipsoidBatchRaycast"), Size, OpIterations, [&](int32 Iteration)
+		{
+			const int32 Index = Iteration % PoolNum;
+			float Time;
+			int32 Hit;
+			Batch.Raycast(MakeArrayView(&Points[Index], 1), MakeArrayView(&Ends[Index], 1), MakeArrayView(&Time, 1), MakeArrayView(&Hit, 1));
+			ConsumeBenchmarkResult(Time);
+		});
+	}
+
+	/// //////////////////////
+
+	// Scaling with the number of limbs solved at once
+	for (const int32 Size : Sizes)
+	{
+		const int32 OpIterations = FMath::Max(Iterations / Size, 1);
+
+		RunKernelBenchmark(TEXT("HingeLoop"), Size, OpIterations, [&](int32 Iteration)
+		{
+			float Sum = 0.0f;
+			for (int32 Limb = 0; Limb < Size; Limb++)
+			{
+				const int32 Index = (Iteration + Limb) % PoolNum;
+				const FVector Delta = Points[Index] - Ends[Index];
+				const float Norm = Delta.Size();
+				const FVector Normal = Delta / Norm;
+				const FVector Direction = FVector::VectorPlaneProject(Ends[(Index + 1) % PoolNum], Normal).GetSafeNormal();
+
+				float h, x;
+				FRigUnit_HingeIK::ComputeTriangle(150.0f, 150.0f, Norm, h, x);
+				Sum += (Ends[Index] + Normal * x + Direction * h).X;
+			}
+			ConsumeBenchmarkResult(Sum);
+		});
+
+		FHingeIKBatch Batch;
+		Batch.Reset(Size);
+		RunKernelBenchmark(TEXT("HingeBatch"), Size, OpIterations, [&](int32 Iteration)
+		{
+			for (int32 Limb = 0; Limb < Size; Limb++)
+			{
+				const int32 Index = (Iteration + Limb) % PoolNum;
+				Batch.Set(Limb, Ends[Index], Points[Index], Ends[(Index + 1) % PoolNum], 150.0f, 150.0f);
+			}
+			Batch.Solve();
+
+			float Sum = 0.0f;
+			for (int32 Limb = 0; Limb < Size; Limb++)
+			{
+				Sum += Batch.GetHinge(Limb).X;
+			}
+			ConsumeBenchmarkResult(Sum);
+		});
+	}
+
+	/// //////////////////////
+
+	// Scaling with chain length, one forward and backward pass per op
+	for (const int32 Size : Sizes)
+	{
+		const int32 ChainNum = Size + 1;
+		const int32 OpIterations = FMath::Max(Iterations / ChainNum, 1);
+
+		TArray<FTransform> Rest, RestInverse, Chain;
+		FTransform Transform = FTransform::Identity;
+		for (int32 Index = 0; Index < ChainNum; Index++)
+		{
+			const FTransform Local = FTransform(FQuat(FVector::UpVector, Random.FRandRange(-0.2f, 0.2f)), FVector(10.0f, 0.0f, 0.0f));
+			Rest.Emplace(Local);
+			RestInverse.Emplace(Local.Inverse());
+			Transform = Local * Transform;
+			Chain.Emplace(Transform);
+		}
+
+		const FTransform Root = Chain[0];
+		RunKernelBenchmark(TEXT("ConeFABRIKPasses"), ChainNum, OpIterations, [&](int32 Iteration)
+		{
+			const FTransform Objective = FTransform(Points[Iteration % PoolNum] * (ChainNum * 10.0f / 300.0f));
+			ConsumeBenchmarkResult(FRigUnit_ConeFABRIK::FabrikForward(Chain, Rest, Root, Objective, 0.5f));
+			FRigUnit_ConeFABRIK::FabrikBackward(Chain, RestInverse, Objective, 0.5f);
+		});
+	}
+
+	/// //////////////////////
+
+	// Whole unit executions on synthetic hierarchies, scaling with chain and ring length
+	for (const int32 Size : Sizes)
+	{
+		const int32 ChainNum = Size + 1;
+		const int32 RingNum = FMath::Max(Size, 3);
+		const int32 OpIterations = FMath::Max(Iterations / (ChainNum * 10), 1);
+
+		FBenchmarkRig Rig;
+		Rig.Build(ChainNum, RingNum, Seed, nullptr);
+
+		// First execution resolves element caches and the collider set
+		TUniquePtr<FBenchmarkRigUnits> Units = MakeUnique<FBenchmarkRigUnits>();
+		Units->Setup(Rig, nullptr);
+		Units->Execute(Rig, 0);
+
+		const FVector Tip = Rig.Hierarchy->GetGlobalTransform(Rig.Chain.Last()).GetLocation();
+		RunKernelBenchmark(TEXT("SpineIK"), ChainNum, OpIterations, [&](int32 Iteration)
+		{
+			Units->SpineIK.Objective = FTransform(Tip + Points[Iteration % PoolNum] * (ChainNum / 300.0f));
+			ExecuteBenchmarkUnit(Units->SpineIK, Rig.ExecuteContext);
+		});
+
+		RunKernelBenchmark(TEXT("LatticeTransform"), ChainNum, OpIterations, [&](int32 Iteration)
+		{
+			ExecuteBenchmarkUnit(Units->LatticeTransform, Rig.ExecuteContext);
+		});
+
+		RunKernelBenchmark(TEXT("EllipsoidLineCollideMulti"), ChainNum - 1, OpIterations, [&](int32 Iteration)
+		{
+			ExecuteBenchmarkUnit(Units->LineCollide, Rig.ExecuteContext);
+		});
+
+		RunKernelBenchmark(TEXT("EllipsoidRingCast"), RingNum, OpIterations, [&](int32 Iteration)
+		{
+			ExecuteBenchmarkUnit(Units->RingCast, Rig.ExecuteContext);
+		});
+
+		RunKernelBenchmark(TEXT("ConeFABRIK"), ChainNum, OpIterations, [&](int32 Iteration)
+		{
+			Units->ConeFABRIK.Objective = FTransform(Tip + Points[Iteration % PoolNum] * (ChainNum / 300.0f));
+			ExecuteBenchmarkUnit(Units->ConeFABRIK, Rig.ExecuteContext);
+		});
+
+		RunKernelBenchmark(TEXT("BSplineIK"), ChainNum, OpIterations, [&](int32 Iteration)
+		{
+			Units->BSplineIK.Objective = FTransform(Tip + Points[Iteration % PoolNum] * (ChainNum / 300.0f));
+			ExecuteBenchmarkUnit(Units->BSplineIK, Rig.ExecuteContext);
+		});
+
+		RunKernelBenchmark(TEXT("SplineIK"), ChainNum, OpIterations, [&](int32 Iteration)
+		{
+			Units->SplineIK.Objective = FTransform(Tip + Points[Iteration % PoolNum] * (ChainNum / 300.0f));
+			ExecuteBenchmarkUnit(Units->SplineIK, Rig.ExecuteContext);
+		});
+
+		RunKernelBenchmark(TEXT("EllipsoidChainCollide"), ChainNum, OpIterations, [&](int32 Iteration)
+		{
+			ExecuteBenchmarkUnit(Units->ChainCollide, Rig.ExecuteContext);
+		});
+
+		RunKernelBenchmark(TEXT("PowerDirection"), ChainNum, OpIterations, [&](int32 Iteration)
+		{
+			ExecuteBenchmarkUnit(Units->PowerDirection, Rig.ExecuteContext);
+		});
+
+		// Pose reset, animated inputs and every unit in order, like one rig evaluation
+		RunKernelBenchmark(TEXT("RigExecute"), ChainNum, OpIterations, [&](int32 Iteration)
+		{
+			Units->Execute(Rig, Iteration);
+		});
+
+		ConsumeBenchmarkResult(Rig.Hierarchy->GetGlobalTransform(Rig.Chain.Last()).GetLocation().X);
+	}
+
+	/// //////////////////////
+
+	// Limb units on the first bones of a synthetic chain, their cost doesn't depend on any size
+	{
+		FBenchmarkRig Rig;
+		Rig.Build(4, 3, Seed, nullptr);
+
+		TUniquePtr<FBenchmarkRigUnits> Units = MakeUnique<FBenchmarkRigUnits>();
+		Units->Setup(Rig, nullptr);
+		Units->Execute(Rig, 0);
+
+		// Targets within reach of the first bones
+		const FVector Root = Rig.Hierarchy->GetGlobalTransform(Rig.Chain[0]).GetLocation();
+		auto GetLimbObjective = [&](int32 Iteration, float Reach)
+		{
+			return FTransform(Root + Points[Iteration % PoolNum].GetSafeNormal() * Reach);
+		};
+
+		RunKernelBenchmark(TEXT("HingeIK"), 3, Iterations, [&](int32 Iteration)
+		{
+			Units->HingeIK.Objective = GetLimbObjective(Iteration, 15.0f);
+			ExecuteBenchmarkUnit(Units->HingeIK, Rig.ExecuteContext);
+		});
+
+		RunKernelBenchmark(TEXT("ArmIK"), 3, Iterations, [&](int32 Iteration)
+		{
+			Units->ArmIK.Objective = GetLimbObjective(Iteration, 15.0f);
+			ExecuteBenchmarkUnit(Units->ArmIK, Rig.ExecuteContext);
+		});
+
+		RunKernelBenchmark(TEXT("ClavicleIK"), 4, Iterations, [&](int32 Iteration)
+		{
+			Units->ClavicleIK.Objective = GetLimbObjective(Iteration, 25.0f);
+			ExecuteBenchmarkUnit(Units->ClavicleIK, Rig.ExecuteContext);
+		});
+
+		RunKernelBenchmark(TEXT("DigitigradeIK"), 4, Iterations, [&](int32 Iteration)
+		{
+			Units->DigitigradeIK.Objective = GetLimbObjective(Iteration, 25.0f);
+			ExecuteBenchmarkUnit(Units->DigitigradeIK, Rig.ExecuteContext);
+		});
+
+		ConsumeBenchmarkResult(Rig.Hierarchy->GetGlobalTransform(Rig.Chain[3]).GetLocation().X);
+	}
+
+	/// //////////////////////
+
+	ReportProjectionAccuracy(Transforms, Points);
+
+	return 0;
+}
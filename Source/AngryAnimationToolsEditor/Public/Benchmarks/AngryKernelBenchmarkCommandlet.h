@@ -0,0 +1,24 @@
+
+
+#pragma once
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+
+#include "AngryKernelBenchmarkCommandlet.generated.h"
+
+/**
+ * Times the math kernels used by the rig units on synthetic data, and whole unit executions on synthetic hierarchies.
+ * Run headless with: -run=AngryKernelBenchmark [-Iterations=100000] [-Sizes=2,4,8,16,32,64] [-Seed=0]
+ * With -Stress [-Instances=512] [-Rounds=8] [-PreviewAnimation=/Path/To.Anim] instead executes the units of many synthetic rig instances
+ * in parallel, each on its own hierarchy, and fails if any differ from serial evaluation.
+ */
+UCLASS()
+class UAngryKernelBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UAngryKernelBenchmarkCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};